@@ -0,0 +1,355 @@
+#include "../include/Database_handler.h"
+#include "../include/RecordStore.h"
+#include "../include/IdAllocator.h"
+#include "../include/Student.h"
+#include "../include/Teacher.h"
+#include "../include/Staff.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <cstdlib>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#define mkdir(path, mode) _mkdir(path)
+#define chdir _chdir
+#define getcwd _getcwd
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// Timings of the persistence and lookup hot paths at 1K/100K/1M records:
+//   save_person        write the three data files, per record
+//   read_person        parse them back into an empty store, per record
+//   get_person_by_id   id -> record lookup (store.find + at), per lookup
+//   give_id            IdAllocator::allocate on a seeded allocator
+//   add_delete_churn   erase a random record and add a new one, per pair
+//
+// Every case runs --reps times; the median and the fastest repetition are
+// reported in nanoseconds per operation. --json writes the results in a
+// stable format for tracking across commits, --compare reads such a file
+// back and fails (exit code 1) when a case got slower than --threshold
+// percent.
+//
+// HotPathBenchmark [max_records] [--reps N] [--json out.json]
+//                  [--compare baseline.json] [--threshold PERCENT] [--label TEXT]
+//
+// save_person/read_person use ../data, so the benchmark moves into a
+// scratch directory first and never touches the real data files.
+
+struct Result {
+    string benchmark;
+    int records;
+    long long ops;          // Operations per repetition
+    double ns_per_op;       // Median repetition
+    double min_ns_per_op;   // Fastest repetition
+};
+
+const char *FIRST[] = {"Muhammad", "Ahmed", "Ali", "Hassan", "Usman", "Bilal", "Fatima", "Ayesha", "Zainab", "Sara",
+                       "Hira", "Noor", "Daniyal", "Imran", "Saad", "Rabia"};
+const char *LAST[] = {"Khan", "Ahmed", "Shah", "Malik", "Qureshi", "Siddiqui", "Butt", "Raza", "Iqbal", "Mirza",
+                      "Abbasi", "Zaidi"};
+const char *SUBJECTS[] = {"Math", "Physics", "Chemistry", "Biology", "English", "Urdu", "Computer Science"};
+const char *DESIGNATIONS[] = {"Clerk", "Accountant", "Librarian", "Lab Assistant", "Administrator"};
+
+Person *make_record(int id, mt19937 &random)
+{
+    Person *person;
+    switch (random() % 10)
+    {
+    case 0:
+        person = new Teacher();
+        person->setSubject(SUBJECTS[random() % 7]);
+        break;
+    case 1:
+        person = new Staff();
+        person->setDesignation(DESIGNATIONS[random() % 5]);
+        break;
+    default:
+        person = new Student();
+        break;
+    }
+    person->setId(id);
+    person->setName(string(FIRST[random() % 16]) + " " + LAST[random() % 12]);
+    person->setAge(18 + (int)(random() % 33));
+    person->setPhone("03" + to_string(100000000 + random() % 900000000));
+    person->setAddress("House " + to_string(random() % 500) + ", Street " + to_string(random() % 40));
+    return person;
+}
+
+void fill_store(RecordStore &store, IdAllocator &ids, int records, mt19937 &random)
+{
+    store.reserve(records);
+    for (int i = 0; i < records; i++)
+    {
+        store.insert(make_record(ids.allocate(), random));
+    }
+}
+
+// Runs body reps times; setup (untimed) runs before each repetition
+Result measure(const string &name, int records, long long ops, int reps, const function<void()> &setup,
+               const function<void()> &body)
+{
+    vector<double> samples;
+    for (int rep = 0; rep < reps; rep++)
+    {
+        setup();
+        auto start = chrono::steady_clock::now();
+        body();
+        double elapsed = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        samples.push_back(elapsed / ops);
+    }
+    sort(samples.begin(), samples.end());
+    Result result = {name, records, ops, samples[samples.size() / 2], samples[0]};
+    cout << "  " << name << string(name.size() < 18 ? 18 - name.size() : 0, ' ') << result.ns_per_op
+         << " ns/op (min " << result.min_ns_per_op << ", " << ops << " ops)" << endl;
+    return result;
+}
+
+void run_size(int records, int reps, vector<Result> &results)
+{
+    cout << records << " records" << endl;
+    mt19937 random(42);
+    RecordStore store;
+    IdAllocator ids;
+    fill_store(store, ids, records, random);
+    auto nothing = []() {};
+
+    ensureDataDirectory();
+    results.push_back(measure("save_person", records, records, reps, nothing, [&]() { save_person(store); }));
+
+    RecordStore loaded;
+    IdAllocator loaded_ids;
+    results.push_back(measure(
+        "read_person", records, records, reps,
+        [&]()
+        {
+            loaded.clear();
+            loaded_ids.reset();
+        },
+        [&]() { read_person(loaded, loaded_ids); }));
+    if (loaded.size() != records)
+    {
+        cerr << "read_person loaded " << loaded.size() << " of " << records << " records" << endl;
+    }
+    loaded.clear();
+
+    const int LOOKUPS = 1000000;
+    vector<int> targets(LOOKUPS);
+    for (int &id : targets)
+    {
+        id = 1001 + (int)(random() % records);
+    }
+    long long checksum = 0;
+    results.push_back(measure("get_person_by_id", records, LOOKUPS, reps, nothing,
+                              [&]()
+                              {
+                                  for (int id : targets)
+                                  {
+                                      checksum += store.at(store.find(id))->getAge();
+                                  }
+                              }));
+
+    const int ALLOCATIONS = 1000000;
+    IdAllocator seeded;
+    results.push_back(measure(
+        "give_id", records, ALLOCATIONS, reps,
+        [&]()
+        {
+            seeded.reset();
+            for (int i = 0; i < records; i++)
+            {
+                seeded.seed(1001 + i);
+            }
+        },
+        [&]()
+        {
+            for (int i = 0; i < ALLOCATIONS; i++)
+            {
+                checksum += seeded.allocate();
+            }
+        }));
+
+    // Steady state: the store keeps its size, ids are released and reused
+    const int CHURN = min(records, 100000);
+    results.push_back(measure("add_delete_churn", records, CHURN, reps, nothing,
+                              [&]()
+                              {
+                                  for (int i = 0; i < CHURN; i++)
+                                  {
+                                      int slot = store.find(1001 + (int)(random() % records));
+                                      if (slot == -1)
+                                          continue;
+                                      int id = store.at(slot)->getId();
+                                      store.erase(slot);
+                                      ids.release(id);
+                                      store.insert(make_record(ids.allocate(), random));
+                                  }
+                              }));
+    if (checksum == 42)
+    {
+        cout << "";   // Keeps the lookups from being optimized away
+    }
+}
+
+string json_escape(const string &text)
+{
+    string escaped;
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+        if ((unsigned char)c >= 0x20)
+            escaped += c;
+    }
+    return escaped;
+}
+
+// One result per line, so --compare can read the file back line by line
+void write_json(ostream &out, const string &label, const vector<Result> &results)
+{
+    out << "{\n  \"suite\": \"hot_paths\",\n  \"label\": \"" << json_escape(label) << "\",\n  \"unit\": \"ns_per_op\",\n"
+        << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const Result &r = results[i];
+        out << "    {\"benchmark\": \"" << r.benchmark << "\", \"records\": " << r.records << ", \"ops\": " << r.ops
+            << ", \"ns_per_op\": " << r.ns_per_op << ", \"min_ns_per_op\": " << r.min_ns_per_op << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+// Value after "key": on a result line, empty if absent
+string json_field(const string &line, const string &key)
+{
+    size_t at = line.find("\"" + key + "\":");
+    if (at == string::npos)
+    {
+        return "";
+    }
+    at = line.find_first_not_of(" \"", at + key.size() + 3);
+    size_t end = line.find_first_of(",\"}", at);
+    return at == string::npos ? "" : line.substr(at, end - at);
+}
+
+bool read_baseline(const string &path, map<string, double> &baseline)
+{
+    ifstream file(path);
+    if (!file)
+    {
+        return false;
+    }
+    string line;
+    while (getline(file, line))
+    {
+        string name = json_field(line, "benchmark"), records = json_field(line, "records");
+        string time = json_field(line, "ns_per_op");
+        if (!name.empty() && !records.empty() && !time.empty())
+        {
+            baseline[name + "/" + records] = atof(time.c_str());
+        }
+    }
+    return true;
+}
+
+int compare(const map<string, double> &baseline, const vector<Result> &results, double threshold)
+{
+    int regressions = 0;
+    cout << "\nAgainst baseline (threshold " << threshold << "%):" << endl;
+    for (const Result &r : results)
+    {
+        map<string, double>::const_iterator it = baseline.find(r.benchmark + "/" + to_string(r.records));
+        if (it == baseline.end() || it->second <= 0)
+        {
+            continue;
+        }
+        double change = (r.ns_per_op - it->second) * 100.0 / it->second;
+        bool regressed = change > threshold;
+        regressions += regressed ? 1 : 0;
+        cout << "  " << r.benchmark << " @ " << r.records << ": " << it->second << " -> " << r.ns_per_op << " ns/op ("
+             << (change >= 0 ? "+" : "") << change << "%)" << (regressed ? "  REGRESSION" : "") << endl;
+    }
+    return regressions;
+}
+
+int main(int argc, char *argv[])
+{
+    int max_records = 1000000, reps = 5;
+    double threshold = 10;
+    string json_path, baseline_path, label;
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "--reps" && i + 1 < argc)
+            reps = max(1, atoi(argv[++i]));
+        else if (arg == "--json" && i + 1 < argc)
+            json_path = argv[++i];
+        else if (arg == "--compare" && i + 1 < argc)
+            baseline_path = argv[++i];
+        else if (arg == "--threshold" && i + 1 < argc)
+            threshold = atof(argv[++i]);
+        else if (arg == "--label" && i + 1 < argc)
+            label = argv[++i];
+        else
+            max_records = atoi(argv[i]);
+    }
+
+    // Paths given on the command line are relative to where it was run
+    char here[4096];
+    string origin = getcwd(here, sizeof(here)) != nullptr ? string(here) + "/" : "";
+    auto from_origin = [&](const string &path) { return path.empty() || path[0] == '/' ? path : origin + path; };
+    json_path = from_origin(json_path);
+    baseline_path = from_origin(baseline_path);
+
+    map<string, double> baseline;
+    if (!baseline_path.empty() && !read_baseline(baseline_path, baseline))
+    {
+        cerr << "Cannot read baseline " << baseline_path << endl;
+        return 2;
+    }
+
+    mkdir("hotpath_bench", 0755);
+    mkdir("hotpath_bench/work", 0755);
+    if (chdir("hotpath_bench/work") != 0)
+    {
+        cerr << "Cannot create scratch directory." << endl;
+        return 2;
+    }
+
+    cout << "Hot path benchmark (median of " << reps << " repetitions)" << endl;
+    vector<Result> results;
+    const int sizes[] = {1000, 100000, 1000000};
+    for (int records : sizes)
+    {
+        if (records <= max_records)
+            run_size(records, reps, results);
+    }
+
+    if (!json_path.empty())
+    {
+        ofstream out(json_path);
+        write_json(out, label, results);
+        if (!out)
+        {
+            cerr << "Cannot write " << json_path << endl;
+            return 2;
+        }
+        cout << "Results written to " << json_path << endl;
+    }
+    if (!baseline_path.empty() && compare(baseline, results, threshold) > 0)
+    {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,196 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Load generator for server mode (sms --serve). Every client thread keeps
+// one connection and sends requests back to back: get by random id, ranked
+// name search, and a share of modify requests that rewrite a random
+// record's age. Reports overall QPS and latency percentiles per kind.
+//
+// LoadGenerator [socket] [--clients N] [--seconds S] [--writes PERCENT]
+
+const char *QUERIES[] = {"muhamad ali", "ayesha sidiqui", "bilal", "fatma", "hasan raza", "zain", "sara ahmed"};
+
+class Connection {
+private:
+    int fd;
+    string pending;
+
+public:
+    Connection() : fd(-1) {}
+    ~Connection()
+    {
+        if (fd >= 0)
+            close(fd);
+    }
+
+    bool open(const string &path)
+    {
+        sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        return fd >= 0 && connect(fd, (sockaddr *)&address, sizeof(address)) == 0;
+    }
+
+    // Send one request and read up to its status line, which is returned
+    bool request(const string &line, string &status)
+    {
+        string data = line + "\n";
+        if (send(fd, data.data(), data.size(), 0) != (ssize_t)data.size())
+            return false;
+        char buffer[8192];
+        while (true)
+        {
+            size_t start = 0, end;
+            while ((end = pending.find('\n', start)) != string::npos)
+            {
+                string reply = pending.substr(start, end - start);
+                start = end + 1;
+                if (reply.compare(0, 2, "OK") == 0 || reply.compare(0, 3, "ERR") == 0)
+                {
+                    pending.erase(0, start);
+                    status = reply;
+                    return true;
+                }
+            }
+            pending.erase(0, start);
+            ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+            if (received <= 0)
+                return false;
+            pending.append(buffer, (size_t)received);
+        }
+    }
+};
+
+struct ClientResult {
+    vector<double> reads;    // Latencies in microseconds
+    vector<double> writes;
+    long long errors = 0;
+    bool failed = false;
+};
+
+void run_client(const string &path, int index, int high_water, int write_percent,
+                chrono::steady_clock::time_point deadline, ClientResult &result)
+{
+    Connection connection;
+    if (!connection.open(path))
+    {
+        result.failed = true;
+        return;
+    }
+    mt19937 random(1234 + index);
+    string status;
+    while (chrono::steady_clock::now() < deadline)
+    {
+        int roll = (int)(random() % 100);
+        int id = 1001 + (int)(random() % (unsigned)max(1, high_water - 1000));
+        string line;
+        bool write = roll < write_percent;
+        if (write)
+            line = "modify`" + to_string(id) + "``" + to_string(18 + random() % 33) + "``";
+        else if (roll % 4 == 0)
+            line = string("find`") + QUERIES[random() % 7];
+        else
+            line = "get`" + to_string(id);
+
+        auto start = chrono::steady_clock::now();
+        if (!connection.request(line, status))
+        {
+            result.failed = true;
+            return;
+        }
+        double micros = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+        (write ? result.writes : result.reads).push_back(micros);
+        // Unknown ids are expected after deletes, only count other errors
+        if (status.compare(0, 3, "ERR") == 0 && status.find("no person") == string::npos)
+            result.errors++;
+    }
+}
+
+void report(const char *label, vector<double> &latencies)
+{
+    if (latencies.empty())
+    {
+        cout << label << ": none" << endl;
+        return;
+    }
+    sort(latencies.begin(), latencies.end());
+    cout << label << ": " << latencies.size() << " requests, p50 " << latencies[latencies.size() / 2] << " us, p99 "
+         << latencies[latencies.size() * 99 / 100] << " us, max " << latencies.back() << " us" << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    string path = "../data/sms.sock";
+    int clients = 8, seconds = 5, write_percent = 10;
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "--clients" && i + 1 < argc)
+            clients = atoi(argv[++i]);
+        else if (arg == "--seconds" && i + 1 < argc)
+            seconds = atoi(argv[++i]);
+        else if (arg == "--writes" && i + 1 < argc)
+            write_percent = atoi(argv[++i]);
+        else
+            path = arg;
+    }
+
+    Connection probe;
+    string status;
+    if (!probe.open(path) || !probe.request("stats", status))
+    {
+        cerr << "Cannot reach a server on " << path << endl;
+        return 1;
+    }
+    int records = 0, high_water = 0;
+    sscanf(status.c_str(), "OK %d %d", &records, &high_water);
+    cout << "Load: " << clients << " clients, " << seconds << " s, " << write_percent << "% writes, " << records
+         << " records on the server" << endl;
+
+    vector<ClientResult> results(clients);
+    vector<thread> threads;
+    auto deadline = chrono::steady_clock::now() + chrono::seconds(seconds);
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < clients; i++)
+    {
+        threads.emplace_back(run_client, path, i, high_water, write_percent, deadline, ref(results[i]));
+    }
+    for (thread &t : threads)
+    {
+        t.join();
+    }
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    vector<double> reads, writes;
+    long long errors = 0;
+    int failed = 0;
+    for (ClientResult &result : results)
+    {
+        reads.insert(reads.end(), result.reads.begin(), result.reads.end());
+        writes.insert(writes.end(), result.writes.begin(), result.writes.end());
+        errors += result.errors;
+        failed += result.failed ? 1 : 0;
+    }
+    cout << "Throughput : " << (reads.size() + writes.size()) / elapsed << " requests/s" << endl;
+    report("Reads      ", reads);
+    report("Writes     ", writes);
+    if (errors > 0 || failed > 0)
+    {
+        cout << "Errors     : " << errors << " error replies, " << failed << " client(s) disconnected" << endl;
+    }
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,103 @@
+#include "../include/RecordStore.h"
+#include "../include/Student.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+
+using namespace std;
+
+// Ranked name search over a large roster: time to index every record,
+// latency of partial and misspelled queries, and cost of keeping the
+// index current while records are renamed.
+// Names repeat like on a real roster; pass "distinct" as the second
+// argument to add a random word to every name (worst case for the index).
+
+double milliseconds(chrono::steady_clock::duration elapsed)
+{
+    return chrono::duration<double, milli>(elapsed).count();
+}
+
+const char *FIRST[] = {"Muhammad", "Ahmed", "Ali", "Hassan", "Hussain", "Usman", "Bilal", "Hamza", "Zain", "Omar",
+                       "Fatima", "Ayesha", "Zainab", "Maryam", "Sana", "Hira", "Sara", "Amna", "Iqra", "Noor",
+                       "Daniyal", "Faisal", "Imran", "Kamran", "Saad", "Talha", "Waqas", "Yasir", "Asad", "Fahad",
+                       "Mehwish", "Rabia", "Saima", "Nadia", "Farah", "Huma", "Kiran", "Laiba", "Mahnoor", "Areeba"};
+const char *LAST[] = {"Khan", "Ahmed", "Ali", "Hussain", "Shah", "Malik", "Qureshi", "Siddiqui", "Butt", "Chaudhry",
+                      "Sheikh", "Raza", "Iqbal", "Javed", "Mirza", "Abbasi", "Baig", "Rana", "Awan", "Zaidi",
+                      "Rizvi", "Hashmi", "Gillani", "Bukhari", "Niazi", "Khattak", "Afridi", "Yousafzai", "Memon", "Soomro"};
+
+bool distinct = false;
+
+string name_for(mt19937 &random)
+{
+    string name = FIRST[random() % 40];
+    name += ' ';
+    name += FIRST[random() % 40];
+    name += ' ';
+    name += LAST[random() % 30];
+    if (distinct)
+    {
+        name += ' ';
+        for (int i = 0; i < 6; i++)
+        {
+            name += (char)('a' + random() % 26);
+        }
+    }
+    return name;
+}
+
+int main(int argc, char *argv[])
+{
+    int rows = argc > 1 ? stoi(argv[1]) : 1000000;
+    distinct = argc > 2 && string(argv[2]) == "distinct";
+    mt19937 random(7);
+
+    RecordStore store;
+    store.reserve(rows);
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < rows; i++)
+    {
+        Person *person = new Student();
+        person->setId(1001 + i);
+        person->setAge(18 + i % 33);
+        person->setName(name_for(random));
+        store.insert(person);
+    }
+    double load_time = milliseconds(chrono::steady_clock::now() - start);
+
+    cout << "Name search benchmark: " << rows << (distinct ? " records, distinct names" : " records") << endl;
+    cout << "Insert with indexing : " << load_time << " ms" << endl;
+
+    const char *queries[] = {"muhamad ali khan", "ayesha sidiqui", "bilal", "fatma zaidi", "hasan raza",
+                             "mehwish", "kamran yousafzai", "noor fatima bukhari", "zain", "saad niazi"};
+    vector<double> latencies;
+    size_t hits = 0;
+    for (int round = 0; round < 10; round++)
+    {
+        for (const char *query : queries)
+        {
+            start = chrono::steady_clock::now();
+            hits += store.find_by_name(query, 20).size();
+            latencies.push_back(milliseconds(chrono::steady_clock::now() - start));
+        }
+    }
+    sort(latencies.begin(), latencies.end());
+    cout << "Query (top 20)       : p50 " << latencies[latencies.size() / 2] << " ms, p99 "
+         << latencies[latencies.size() * 99 / 100] << " ms, max " << latencies.back() << " ms ("
+         << hits / latencies.size() << " results per query)" << endl;
+
+    const int RENAMES = 1000;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < RENAMES; i++)
+    {
+        int slot = (int)(random() % rows);
+        Person *person = store.at(slot);
+        person->setName(name_for(random));
+        person->save(store, slot);
+    }
+    cout << "Rename + re-index    : " << milliseconds(chrono::steady_clock::now() - start) / RENAMES
+         << " ms per record" << endl;
+    return 0;
+}
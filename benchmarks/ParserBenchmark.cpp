@@ -0,0 +1,81 @@
+#include "../include/RecordParser.h"
+#include "../include/Person.h"
+#include <iostream>
+#include <string>
+#include <chrono>
+
+using namespace std;
+
+// Throughput of the backtick record parser, in MB/s.
+// Builds a teacher file in memory and parses it several times, once only
+// tokenizing and once creating the records.
+
+string build_teacher_file(int rows)
+{
+    const char *subjects[] = {"Math", "Physics", "Chemistry", "Biology", "English"};
+    string buffer;
+    for (int i = 0; i < rows; i++)
+    {
+        buffer += "Teacher Name " + to_string(i) + "`" + to_string(25 + i % 25) + "`0300" +
+                  to_string(1000000 + i) + "`House " + to_string(i % 500) + ", Street 7`" +
+                  to_string(1001 + i) + "`" + subjects[i % 5] + "\n";
+    }
+    return buffer;
+}
+
+double megabytes_per_second(size_t bytes, chrono::steady_clock::duration elapsed)
+{
+    double seconds = chrono::duration<double>(elapsed).count();
+    return (bytes / (1024.0 * 1024.0)) / seconds;
+}
+
+int main(int argc, char *argv[])
+{
+    int rows = argc > 1 ? stoi(argv[1]) : 500000;
+    const int RUNS = 5;
+    string buffer = build_teacher_file(rows);
+    const RecordLayout &layout = RECORD_LAYOUTS[1];
+
+    cout << "Parser benchmark: " << rows << " rows, " << buffer.size() / 1024 << " KB per run" << endl;
+
+    // Tokenize and convert numbers only
+    auto start = chrono::steady_clock::now();
+    long long checksum = 0;
+    for (int run = 0; run < RUNS; run++)
+    {
+        size_t begin = 0;
+        while (begin < buffer.size())
+        {
+            size_t end = buffer.find('\n', begin);
+            string_view fields[RECORD_MAX_FIELDS];
+            split_record(string_view(buffer).substr(begin, end - begin), fields, layout.field_count);
+            int id = 0;
+            parse_int(fields[4], id);
+            checksum += id;
+            begin = end + 1;
+        }
+    }
+    auto tokenize_time = chrono::steady_clock::now() - start;
+
+    // Full parse into Teacher objects
+    start = chrono::steady_clock::now();
+    int parsed = 0;
+    for (int run = 0; run < RUNS; run++)
+    {
+        parse_records(
+            buffer, layout,
+            [&](Person *person)
+            {
+                parsed++;
+                delete person;
+            },
+            [](string_view) {});
+    }
+    auto parse_time = chrono::steady_clock::now() - start;
+
+    cout << "Tokenize only : " << megabytes_per_second(buffer.size() * RUNS, tokenize_time) << " MB/s"
+         << " (checksum " << checksum << ")" << endl;
+    cout << "Parse records : " << megabytes_per_second(buffer.size() * RUNS, parse_time) << " MB/s"
+         << " (" << parsed / RUNS << " records per run)" << endl;
+    return 0;
+}
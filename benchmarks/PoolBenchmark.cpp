@@ -0,0 +1,123 @@
+#include "../include/Student.h"
+#include "../include/Teacher.h"
+#include "../include/Staff.h"
+#include "../include/ThreadPool.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+
+using namespace std;
+
+// Load and teardown cost of the per-type record pools against plain
+// new/delete. "::new" and "::delete" bypass the class operators, which
+// gives the general heap baseline with the same objects.
+
+double milliseconds(chrono::steady_clock::duration elapsed)
+{
+    return chrono::duration<double, milli>(elapsed).count();
+}
+
+Person *make_record(int i, bool pooled)
+{
+    Person *person;
+    switch (i % 3)
+    {
+    case 0:
+        person = pooled ? new Student() : ::new Student();
+        break;
+    case 1:
+        person = pooled ? new Teacher() : ::new Teacher();
+        person->setSubject("Mathematics and Physics");
+        break;
+    default:
+        person = pooled ? new Staff() : ::new Staff();
+        person->setDesignation("Administrative Officer");
+        break;
+    }
+    person->setId(1001 + i);
+    person->setAge(18 + i % 33);
+    person->setName("Person Name Number " + to_string(i));
+    person->setPhone("0300" + to_string(1000000 + i));
+    person->setAddress("House " + to_string(i % 500) + ", Street 7, Block C");
+    return person;
+}
+
+void destroy_record(Person *person, bool pooled)
+{
+    if (pooled)
+    {
+        delete person;
+        return;
+    }
+    // Global delete needs the concrete type to get the size right
+    switch (person->getKind())
+    {
+    case KIND_STUDENT:
+        ::delete static_cast<Student *>(person);
+        break;
+    case KIND_TEACHER:
+        ::delete static_cast<Teacher *>(person);
+        break;
+    default:
+        ::delete static_cast<Staff *>(person);
+        break;
+    }
+}
+
+// Fill records from several threads, like the chunked parallel loader
+double load(vector<Person *> &records, bool pooled, int threads)
+{
+    int rows = (int)records.size();
+    ThreadPool workers(threads);
+    auto start = chrono::steady_clock::now();
+    workers.run(threads,
+                [&](int task)
+                {
+                    int begin = (int)((long long)rows * task / threads);
+                    int end = (int)((long long)rows * (task + 1) / threads);
+                    for (int i = begin; i < end; i++)
+                    {
+                        records[i] = make_record(i, pooled);
+                    }
+                });
+    return milliseconds(chrono::steady_clock::now() - start);
+}
+
+int main(int argc, char *argv[])
+{
+    int rows = argc > 1 ? stoi(argv[1]) : 1000000;
+    vector<Person *> records(rows);
+
+    cout << "Pool benchmark: " << rows << " records" << endl;
+
+    for (int threads : {1, 4})
+    {
+        double heap_load = load(records, false, threads);
+        auto start = chrono::steady_clock::now();
+        for (Person *person : records)
+        {
+            destroy_record(person, false);
+        }
+        double heap_teardown = milliseconds(chrono::steady_clock::now() - start);
+
+        double pool_load = load(records, true, threads);
+        start = chrono::steady_clock::now();
+        for (Person *person : records)
+        {
+            delete person;
+        }
+        double pool_teardown = milliseconds(chrono::steady_clock::now() - start);
+
+        double bulk_load = load(records, true, threads);
+        start = chrono::steady_clock::now();
+        Person::release_pools();
+        double bulk_teardown = milliseconds(chrono::steady_clock::now() - start);
+
+        cout << threads << " loader thread(s)" << endl;
+        cout << "  new/delete     : load " << heap_load << " ms, teardown " << heap_teardown << " ms" << endl;
+        cout << "  pool, delete   : load " << pool_load << " ms, teardown " << pool_teardown << " ms" << endl;
+        cout << "  pool, bulk     : load " << bulk_load << " ms, teardown " << bulk_teardown << " ms" << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,124 @@
+#include "../include/Database_handler.h"
+#include "../include/RecordStore.h"
+#include "../include/Student.h"
+#include "../include/Teacher.h"
+#include "../include/Staff.h"
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#define mkdir(path, mode) _mkdir(path)
+#define chdir _chdir
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// Heap allocations made by one save_person call, and by a full scan of
+// the store through the getters. Neither should grow with the number
+// of records: fields are streamed from const references.
+//
+// save_person writes to ../data, so the benchmark moves into a scratch
+// directory first and never touches the real data files.
+
+static atomic<long long> allocations(0);
+
+void *operator new(size_t size)
+{
+    allocations++;
+    void *block = malloc(size == 0 ? 1 : size);
+    if (block == nullptr)
+    {
+        throw bad_alloc();
+    }
+    return block;
+}
+
+void operator delete(void *block) noexcept { free(block); }
+void operator delete(void *block, size_t) noexcept { free(block); }
+
+void fill_store(RecordStore &store, int rows)
+{
+    const char *subjects[] = {"Math", "Physics", "Chemistry", "Biology", "English"};
+    store.reserve(rows);
+    for (int i = 0; i < rows; i++)
+    {
+        Person *person;
+        if (i % 3 == 0)
+        {
+            person = new Teacher();
+            person->setSubject(subjects[i % 5]);
+        }
+        else if (i % 3 == 1)
+        {
+            person = new Staff();
+            person->setDesignation("Clerk");
+        }
+        else
+        {
+            person = new Student();
+        }
+        person->setName("Person Name " + to_string(i));
+        person->setAge(18 + i % 32);
+        person->setPhone("0300" + to_string(1000000 + i));
+        person->setAddress("House " + to_string(i % 500) + ", Street 7");
+        person->setId(1001 + i);
+        store.insert(person);
+    }
+}
+
+void run(int rows)
+{
+    RecordStore store;
+    fill_store(store, rows);
+
+    long long before = allocations;
+    auto start = chrono::steady_clock::now();
+    save_person(store);
+    auto elapsed = chrono::steady_clock::now() - start;
+    long long save_allocations = allocations - before;
+
+    before = allocations;
+    size_t name_bytes = 0;
+    int teachers = 0;
+    for (Person *person : store)
+    {
+        name_bytes += person->getName().size() + person->getPhone().size() + person->getAddress().size();
+        if (person->getKind() == KIND_TEACHER)
+            teachers++;
+    }
+    long long scan_allocations = allocations - before;
+
+    cout << rows << " records: save_person " << chrono::duration<double, milli>(elapsed).count() << " ms, "
+         << save_allocations << " allocations (" << (double)save_allocations / rows << " per record), scan "
+         << scan_allocations << " allocations (" << teachers << " teachers, " << name_bytes << " bytes)" << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    int max_rows = argc > 1 ? stoi(argv[1]) : 1000000;
+
+    mkdir("save_bench", 0755);
+    mkdir("save_bench/work", 0755);
+    if (chdir("save_bench/work") != 0)
+    {
+        cerr << "Cannot create scratch directory." << endl;
+        return 1;
+    }
+
+    cout << "Save benchmark (allocations per save_person call)" << endl;
+    const int sizes[] = {1000, 100000, 1000000};
+    for (int rows : sizes)
+    {
+        if (rows <= max_rows)
+            run(rows);
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include "../include/RecordStore.h"
+#include "../include/Student.h"
+#include "../include/Teacher.h"
+#include "../include/Staff.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+
+using namespace std;
+
+// Aggregate scan over the roster: count by kind and average age.
+// Compares walking the Person pointers (virtual-free getters, but one
+// cache miss per scattered object) with reading the store's columns.
+// Records are inserted in shuffled order, as after a long run of churn,
+// so slot order does not match heap order.
+
+double milliseconds(chrono::steady_clock::duration elapsed)
+{
+    return chrono::duration<double, milli>(elapsed).count();
+}
+
+int main(int argc, char *argv[])
+{
+    int rows = argc > 1 ? stoi(argv[1]) : 1000000;
+    const int RUNS = 5;
+
+    vector<Person *> people;
+    people.reserve(rows);
+    for (int i = 0; i < rows; i++)
+    {
+        Person *person = Person::create((PersonKind)(i % KIND_COUNT));
+        person->setId(1001 + i);
+        person->setAge(18 + i % 33);
+        person->setName("P" + to_string(i % 1000));
+        people.push_back(person);
+    }
+    shuffle(people.begin(), people.end(), mt19937(42));
+
+    RecordStore store;
+    store.reserve(rows);
+    for (Person *person : people)
+    {
+        store.insert(person);
+    }
+    people.clear();
+
+    cout << "Scan benchmark: " << rows << " records, " << RUNS << " runs" << endl;
+
+    // Pointer chasing through the Person objects
+    auto start = chrono::steady_clock::now();
+    long long checksum = 0;
+    for (int run = 0; run < RUNS; run++)
+    {
+        int counts[KIND_COUNT] = {0};
+        long long age_sum = 0;
+        for (Person *person : store)
+        {
+            counts[person->getKind()]++;
+            age_sum += person->getAge();
+        }
+        checksum += counts[KIND_TEACHER] + age_sum;
+    }
+    double object_time = milliseconds(chrono::steady_clock::now() - start) / RUNS;
+
+    // Columns only
+    start = chrono::steady_clock::now();
+    long long column_checksum = 0;
+    for (int run = 0; run < RUNS; run++)
+    {
+        int counts[KIND_COUNT];
+        store.count_by_kind(counts);
+        AgeStats ages = store.age_stats();
+        column_checksum += counts[KIND_TEACHER] + (long long)(ages.average * ages.count + 0.5);
+    }
+    double column_time = milliseconds(chrono::steady_clock::now() - start) / RUNS;
+
+    // count_by_kind reads the kind column, age_stats reads kinds and ages
+    double column_bytes = (double)store.slot_count() * (sizeof(int) + 2 * sizeof(uint8_t));
+    cout << "Object scan : " << object_time << " ms per run" << endl;
+    cout << "Column scan : " << column_time << " ms per run, "
+         << column_bytes / (column_time / 1000.0) / (1024.0 * 1024.0 * 1024.0) << " GB/s" << endl;
+    cout << "Checksums " << (checksum == column_checksum ? "match" : "DIFFER") << endl;
+    return checksum == column_checksum ? 0 : 1;
+}
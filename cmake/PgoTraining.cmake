@@ -0,0 +1,55 @@
+# PGO training run, invoked by the pgo-train target with cmake -P.
+# Exercises the paths that matter at scale with the instrumented binaries:
+# text import (read_person), snapshot load, batch changes with journal
+# and save, CSV export/import, lookups, churn and ranked name search.
+# Everything happens under WORK_DIR, the real data directory is not used.
+
+foreach(var SMS GEN_ROSTER HOT_PATH NAME_SEARCH WORKLOAD WORK_DIR PROFILE_DIR COMPILER_ID)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "PgoTraining.cmake needs -D ${var}=...")
+    endif()
+endforeach()
+
+# Profiles of an earlier training run would be added to this one
+file(GLOB old_profiles "${PROFILE_DIR}/*")
+if(old_profiles)
+    file(REMOVE ${old_profiles})
+endif()
+file(REMOVE_RECURSE "${WORK_DIR}")
+file(MAKE_DIRECTORY "${WORK_DIR}/build" "${WORK_DIR}/data")
+
+function(run_step label)
+    message(STATUS "pgo-train: ${label}")
+    execute_process(COMMAND ${ARGN}
+        WORKING_DIRECTORY "${WORK_DIR}/build"
+        RESULT_VARIABLE result
+        OUTPUT_QUIET)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "pgo-train: '${label}' failed (${result})")
+    endif()
+endfunction()
+
+run_step("generate a 100000-record roster" "${GEN_ROSTER}" 100000 --seed 2024)
+# The first run imports the text files, the second loads the snapshot the first one wrote
+run_step("batch workload, text import" "${SMS}" --batch "${WORKLOAD}")
+run_step("batch workload, snapshot load" "${SMS}" --batch "${WORKLOAD}")
+run_step("CSV export" "${SMS}" --export "${WORK_DIR}/roster.csv")
+file(REMOVE_RECURSE "${WORK_DIR}/data")
+file(MAKE_DIRECTORY "${WORK_DIR}/data")
+run_step("CSV import" "${SMS}" --import "${WORK_DIR}/roster.csv")
+run_step("hot path benchmark" "${HOT_PATH}" 100000 --reps 1)
+run_step("name search benchmark" "${NAME_SEARCH}" 100000)
+
+if(COMPILER_ID MATCHES "Clang")
+    find_program(LLVM_PROFDATA NAMES llvm-profdata)
+    if(NOT LLVM_PROFDATA)
+        message(FATAL_ERROR "pgo-train: llvm-profdata is needed to merge Clang profiles")
+    endif()
+    file(GLOB raw_profiles "${PROFILE_DIR}/*.profraw")
+    execute_process(COMMAND "${LLVM_PROFDATA}" merge -o "${PROFILE_DIR}/merged.profdata" ${raw_profiles}
+        RESULT_VARIABLE result)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "pgo-train: merging profiles failed")
+    endif()
+endif()
+message(STATUS "pgo-train: profiles written to ${PROFILE_DIR}")
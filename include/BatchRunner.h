@@ -0,0 +1,52 @@
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+#include <string>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include "RecordStore.h"
+#include "IdAllocator.h"
+#include "Journal.h"
+using namespace std;
+
+// Non-interactive command mode: sms --batch ops.txt [--commit-every N]
+// Reads one backtick separated command per line, no menus or pauses:
+//   add`Student`name`age`phone`address
+//   add`Teacher`name`age`phone`address`subject
+//   add`Staff`name`age`phone`address`designation
+//   modify`id`name`age`phone`address[`subject/designation]  (empty field = unchanged)
+//   delete`id
+//   get`id
+//   commit
+// Blank lines and lines starting with # are ignored. Every change goes
+// to the journal; it is synced every commit_every operations (0 = only
+// at the end), and the caller compacts once the run is over.
+class BatchRunner {
+private:
+    RecordStore &store;
+    IdAllocator &ids;
+    Journal &journal;
+    ostream &out;
+    ostream &err;
+    int commit_every;
+    int succeeded;
+    int failed;
+
+    bool run_add(const vector<string> &fields, string &error);
+    bool run_modify(const vector<string> &fields, string &error);
+    bool run_delete(const vector<string> &fields, string &error);
+    bool run_get(const vector<string> &fields, string &error);
+
+public:
+    BatchRunner(RecordStore &store, IdAllocator &ids, Journal &journal, ostream &out, ostream &err, int commit_every = 0);
+
+    // Run every command in the stream, returns the number of failed commands
+    int run(istream &in);
+    bool execute(const string &line, string &error);
+    // One record in get's output format: id`type`name`age`phone`address[`extra]
+    static void write_record(ostream &out, const Person *person);
+
+    int getSucceeded() const;
+    int getFailed() const;
+};
+#endif
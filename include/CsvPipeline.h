@@ -0,0 +1,73 @@
+#ifndef CSVPIPELINE_H
+#define CSVPIPELINE_H
+#include <string>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include "RecordStore.h"
+#include "IdAllocator.h"
+#include "Journal.h"
+using namespace std;
+
+// Streaming CSV import/export for registrar rosters.
+// Rows are read one at a time and validated rows are buffered only up to
+// batch_size before being inserted and journaled together, so memory use
+// of the pipeline does not depend on the file size.
+//
+// The first row is a header naming the columns (any order, case-insensitive):
+//   type, name, age, phone, address, id, subject, designation
+// name, age, phone and address are required. type may be omitted when a
+// default type is set; id may be omitted or left empty to allocate one.
+// Fields follow RFC 4180 quoting ("a, b", "say ""hi""").
+
+// Longest row read_csv_row accepts. A longer one (or a quote that is never
+// closed) is skipped to the end of the line where the limit was hit, so a
+// malformed file cannot pull itself into memory.
+const size_t CSV_MAX_ROW_BYTES = 1 << 20;
+
+// Read one CSV row (may span lines inside quotes), false at end of input.
+// line_number counts the lines read so far. A row over CSV_MAX_ROW_BYTES
+// comes back with no fields and error set.
+bool read_csv_row(istream &in, vector<string> &fields, string &line, long long &line_number, string &error);
+// Append one field to a row, quoting it when needed
+void write_csv_field(ostream &out, const string &field);
+
+struct CsvImportResult {
+    long long rows;
+    long long imported;
+    long long failed;
+    bool aborted;       // Header row missing or unusable, nothing imported
+};
+
+class CsvImporter {
+private:
+    enum Column { TYPE, NAME, AGE, PHONE, ADDRESS, ID, SUBJECT, DESIGNATION, COLUMN_COUNT };
+
+    RecordStore &store;
+    IdAllocator &ids;
+    Journal &journal;
+    ostream &err;
+    int batch_size;
+    string default_type;
+    int columns[COLUMN_COUNT];      // CSV column index per field, -1 if absent
+    vector<Person *> batch;
+
+    bool map_header(const vector<string> &header);
+    Person *build_row(const vector<string> &fields, string &error);
+    void flush_batch();
+
+public:
+    CsvImporter(RecordStore &store, IdAllocator &ids, Journal &journal, ostream &err, int batch_size = 1000);
+    CsvImporter(const CsvImporter &) = delete;
+    CsvImporter &operator=(const CsvImporter &) = delete;
+
+    // Type used when the file has no type column ("Student", "Teacher", "Staff")
+    void setDefaultType(const string &type);
+    CsvImportResult run(istream &in);
+
+    ~CsvImporter();
+};
+
+// Write every record (or only one kind, KIND_COUNT = all), returns rows written
+long long export_csv(const RecordStore &store, ostream &out, PersonKind kind = KIND_COUNT);
+#endif
@@ -1,4 +1,8 @@
 #pragma once
 #include "Person.h"
-void save_person(Person **person);
-Person **read_person(int *ids, int &current_id);
\ No newline at end of file
+#include "RecordStore.h"
+#include "IdAllocator.h"
+void ensureDataDirectory();
+void save_person(const RecordStore &store);
+// Throws length_error, loading nothing, if the string table runs out of room
+void read_person(RecordStore &store, IdAllocator &ids);
\ No newline at end of file
@@ -0,0 +1,45 @@
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+#include <string>
+#include <sstream>
+using namespace std;
+
+// Collects console output and emits it with a single write.
+// Frames nest: begin()/end() pairs can be stacked and the text is written
+// only when the outermost frame ends, so a whole screen composed from
+// several Utility calls still costs one write syscall.
+class FrameBuffer {
+private:
+    ostringstream stream;
+    int depth;
+    static int writes;
+
+public:
+    FrameBuffer();
+    FrameBuffer(const FrameBuffer &) = delete;
+    FrameBuffer &operator=(const FrameBuffer &) = delete;
+
+    ostream &out();
+    void begin();
+    void end();
+    // Emit whatever is buffered now, even inside a frame
+    void flush();
+    bool active() const;
+
+    // Write text to stdout in one call, after draining pending cout output
+    static void write_all(const string &text);
+    static int getWriteCount();
+};
+
+// Opens a frame for the lifetime of the object
+class FrameScope {
+private:
+    FrameBuffer &frame;
+
+public:
+    FrameScope(FrameBuffer &frame) : frame(frame) { frame.begin(); }
+    FrameScope(const FrameScope &) = delete;
+    FrameScope &operator=(const FrameScope &) = delete;
+    ~FrameScope() { frame.end(); }
+};
+#endif
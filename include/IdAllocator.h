@@ -0,0 +1,36 @@
+#ifndef IDALLOCATOR_H
+#define IDALLOCATOR_H
+#include <vector>
+#include <unordered_set>
+using namespace std;
+
+// Hands out unique person IDs in O(1).
+// New IDs come from a monotonic high-water mark starting after 1000.
+// IDs given back with release() are kept in a free set and handed out
+// again before the high-water mark moves. Gaps already present in the
+// text files are not reclaimed; the snapshot keeps the free list, so
+// released IDs survive a restart through it.
+class IdAllocator {
+private:
+    static const int FIRST_ID = 1000;
+    int high_water;
+    vector<int> free_ids;
+    unordered_set<int> free_set;
+
+public:
+    IdAllocator();
+
+    // Record an ID that is already in use (called by read_person per record)
+    void seed(int id);
+    // Next unused ID
+    int allocate();
+    // Give an ID back so it can be reused
+    void release(int id);
+
+    int getHighWater() const;
+    int free_count() const;
+    // Free IDs in release order, the one allocate() returns next last
+    vector<int> free_list() const;
+    void reset();
+};
+#endif
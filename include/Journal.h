@@ -0,0 +1,74 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+#include <string>
+#include <atomic>
+#include "Person.h"
+#include "RecordStore.h"
+#include "IdAllocator.h"
+using namespace std;
+
+const char JOURNAL_PATH[] = "../data/journal.log";
+
+// Append-only write-ahead log of add/modify/delete operations.
+// Every change is appended as one checksummed line and synced to disk, so a
+// crash loses at most the operation in flight. On startup the journal is
+// replayed on top of the base files; compaction folds it into the snapshot
+// and truncates it. Replay is idempotent, so a crash between writing the
+// snapshot and truncating the journal is harmless.
+//
+// Line format (backtick separated, last field is an FNV-1a checksum):
+//   A`type`id`age`name`phone`address`extra`checksum   add
+//   M`type`id`age`name`phone`address`extra`checksum   modify
+//   D`id`checksum                                      delete
+//
+// Appends must come from one thread at a time. sync_through() may run on
+// another thread while appends continue, which lets a server release its
+// record lock before waiting for the disk.
+class Journal {
+private:
+    string path;
+    int fd;
+    atomic<int> entries;    // Operations appended since the last compaction
+    int sync_every;         // fsync after this many appends (group commit)
+    int unsynced;
+    atomic<long long> appended;  // Appends ever made, a position in the log
+    atomic<long long> durable;   // Appends known to be on disk
+
+    bool append(const string &line);
+    static string record_line(char op, Person *person);
+
+public:
+    static const int COMPACT_THRESHOLD = 1000;
+
+    Journal(const string &path = JOURNAL_PATH);
+    Journal(const Journal &) = delete;
+    Journal &operator=(const Journal &) = delete;
+
+    bool open();
+    void close();
+
+    bool log_add(Person *person);
+    bool log_modify(Person *person);
+    bool log_delete(int id);
+
+    // Apply every intact entry to the store. False when an entry whose
+    // checksum matches cannot be applied (each one is reported on cerr).
+    // applied_count receives the number of entries applied.
+    bool replay(RecordStore &store, IdAllocator &ids, int *applied_count = nullptr);
+    // Force pending appends to disk
+    bool sync();
+    // fsync unless every append up to position (a getAppended() value) is
+    // already on disk. Callers serialize these, and one fsync covers every
+    // writer that appended before it.
+    bool sync_through(long long position);
+    // Drop all entries once they are part of the base files
+    bool reset();
+
+    void setSyncEvery(int count);
+    int getEntries() const;
+    long long getAppended() const;
+    bool needs_compaction() const;
+
+    ~Journal();
+};
+#endif
@@ -0,0 +1,114 @@
+#ifndef MEMORYACCOUNTING_H
+#define MEMORYACCOUNTING_H
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+using namespace std;
+
+class RecordStore;
+
+// Subsystems whose heap use is tracked as it is allocated
+enum MemorySubsystem : uint8_t {
+    MEM_RECORDS,    // ObjectPool chunks holding Student/Teacher/Staff
+    MEM_STORE,      // RecordStore slot table, columns and id index
+    MEM_INDEXES,    // RecordIndex (names, trigrams, ages, subjects, designations)
+    MEM_VERSIONS,   // RecordVersions directory, version chains, retired list
+    MEM_COUNT
+};
+
+// Memory picture for the System Statistics screen, in bytes
+struct MemoryReport {
+    size_t record_bytes;         // Live Person objects
+    size_t string_bytes;         // Heap payloads of names and phone numbers
+    size_t interned_bytes;       // StringTable: addresses, subjects, designations
+    size_t tracked[MEM_COUNT];   // Live bytes per subsystem
+    size_t allocations[MEM_COUNT];
+    size_t rss_bytes;            // Resident set of the process, 0 if unknown
+
+    // Pools, strings, interned values and the other tracked subsystems
+    size_t accounted() const;
+};
+
+// Running totals of the bytes each subsystem holds.
+//
+// The containers of the store, the indexes and the versions allocate
+// through TrackingAllocator, the record pools and version chains report
+// their blocks directly, so the figures are exact and cost nothing to
+// read. Strings inside the records use the normal allocator and are
+// measured by walking the store instead (measure()).
+class MemoryAccounting {
+private:
+    struct alignas(64) Counter {
+        atomic<int64_t> bytes{0};
+        atomic<int64_t> blocks{0};
+    };
+    static Counter counters[MEM_COUNT];
+
+public:
+    static void allocated(MemorySubsystem subsystem, size_t bytes)
+    {
+        counters[subsystem].bytes.fetch_add((int64_t)bytes, memory_order_relaxed);
+        counters[subsystem].blocks.fetch_add(1, memory_order_relaxed);
+    }
+    static void released(MemorySubsystem subsystem, size_t bytes)
+    {
+        counters[subsystem].bytes.fetch_sub((int64_t)bytes, memory_order_relaxed);
+        counters[subsystem].blocks.fetch_sub(1, memory_order_relaxed);
+    }
+
+    static size_t in_use(MemorySubsystem subsystem);        // Bytes
+    static size_t allocation_count(MemorySubsystem subsystem);
+    static const char *subsystem_name(MemorySubsystem subsystem);
+
+    // Heap bytes behind a string, 0 when it fits the inline buffer
+    static size_t heap_bytes(const string &value)
+    {
+        static const size_t inline_capacity = string().capacity();
+        return value.capacity() > inline_capacity ? value.capacity() + 1 : 0;
+    }
+
+    static size_t process_rss();
+    // Tracked subsystems plus a walk over the records of store, O(records)
+    static MemoryReport measure(const RecordStore &store);
+    // "512 B", "12.3 KB", "4.0 MB", ...
+    static string format_bytes(size_t bytes);
+
+    MemoryAccounting() = delete;
+};
+
+// Standard allocator that books its memory to a subsystem.
+// Stateless, so containers using it compare, swap and move as usual.
+template <class T, MemorySubsystem S>
+class TrackingAllocator {
+public:
+    typedef T value_type;
+
+    template <class U>
+    struct rebind {
+        typedef TrackingAllocator<U, S> other;
+    };
+
+    TrackingAllocator() noexcept {}
+    template <class U>
+    TrackingAllocator(const TrackingAllocator<U, S> &) noexcept {}
+
+    T *allocate(size_t n)
+    {
+        T *block = static_cast<T *>(::operator new(n * sizeof(T)));
+        MemoryAccounting::allocated(S, n * sizeof(T));
+        return block;
+    }
+    void deallocate(T *block, size_t n) noexcept
+    {
+        MemoryAccounting::released(S, n * sizeof(T));
+        ::operator delete(block);
+    }
+
+    template <class U>
+    bool operator==(const TrackingAllocator<U, S> &) const noexcept { return true; }
+    template <class U>
+    bool operator!=(const TrackingAllocator<U, S> &) const noexcept { return false; }
+};
+#endif
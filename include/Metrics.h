@@ -0,0 +1,98 @@
+#ifndef METRICS_H
+#define METRICS_H
+#include <ostream>
+#include <string>
+#include <cstdint>
+#include <chrono>
+using namespace std;
+
+// Timed operations. Names appear in the JSON and Prometheus output,
+// so new ones go at the end.
+enum MetricTimer : uint8_t {
+    TIMER_LOAD,     // Whole database load at startup
+    TIMER_SAVE,     // save_person
+    TIMER_LOOKUP,   // Record by id (menu, batch and server get)
+    TIMER_SEARCH,   // Secondary index queries (RecordStore::find_by_*)
+    TIMER_ADD,
+    TIMER_MODIFY,
+    TIMER_DELETE,
+    TIMER_COUNT
+};
+
+enum MetricCounter : uint8_t {
+    COUNTER_RECORDS_LOADED,
+    COUNTER_RECORDS_SAVED,
+    COUNTER_LOOKUP_MISSES,
+    COUNTER_JOURNAL_SYNCS,
+    COUNTER_REJECTED_CHANGES,   // add/modify/delete refused by validation
+    COUNTER_COUNT
+};
+
+// Bucket 0 holds durations under 1 us, bucket i (1..30) durations in
+// [2^(i+9), 2^(i+10)) ns, the last one everything longer
+const int METRIC_BUCKETS = 32;
+
+struct TimerStats {
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint64_t buckets[METRIC_BUCKETS];
+
+    double mean_us() const;
+    // Estimated from the buckets, at most one bucket (2x) off
+    double percentile_us(double fraction) const;
+};
+
+struct MetricsSnapshot {
+    TimerStats timers[TIMER_COUNT];
+    uint64_t counters[COUNTER_COUNT];
+};
+
+// Process-wide counters and latency histograms.
+//
+// Every thread records into its own shard with plain relaxed stores, no
+// lock and no shared cache line, so instrumenting a hot path costs two
+// clock reads and a few adds. snapshot() sums the shards. A shard
+// outlives its thread and is handed to the next new thread, so a
+// thread-per-connection server does not grow the registry.
+class Metrics {
+public:
+    static void record(MetricTimer timer, uint64_t nanos);
+    static void count(MetricCounter counter, uint64_t amount = 1);
+
+    // Steady clock in nanoseconds (vDSO clock_gettime on Linux, ~20 ns)
+    static uint64_t now()
+    {
+        return (uint64_t)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    static MetricsSnapshot snapshot();
+    // Start counting from zero again (snapshots subtract a baseline, so
+    // threads that are recording are not disturbed)
+    static void reset();
+
+    static const char *timer_name(MetricTimer timer);       // "load", "save", ...
+    static const char *counter_name(MetricCounter counter); // "records_loaded", ...
+
+    static void write_json(ostream &out);
+    static void write_prometheus(ostream &out);
+    // Writes to path, Prometheus text unless it ends in ".json"
+    static bool write_file(const string &path);
+
+    Metrics() = delete;
+};
+
+// Times the enclosing scope
+class ScopedTimer {
+private:
+    MetricTimer timer;
+    uint64_t start;
+
+public:
+    explicit ScopedTimer(MetricTimer timer) : timer(timer), start(Metrics::now()) {}
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+    ~ScopedTimer() { Metrics::record(timer, Metrics::now() - start); }
+};
+#endif
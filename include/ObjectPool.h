@@ -0,0 +1,98 @@
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <mutex>
+using namespace std;
+
+// Fixed-size block allocator for one record type.
+// Blocks are carved from large chunks, so loading N records costs about
+// N / blocks_per_chunk system allocations. Freed blocks go on a free list
+// and are handed out again first. Chunks are only given back by
+// release_all(), which drops every block of the pool in one step
+// (no destructors run, the caller must not touch the records again).
+// Safe to use from the parallel loader threads.
+//
+// A loader thread opens a LocalCache for its batch. Each pool then hands
+// that thread blocks from a private run of LOCAL_RUN_BLOCKS, carved from
+// the current chunk under one lock, so allocating a record takes no lock.
+class ObjectPool {
+private:
+    size_t block_size;
+    size_t blocks_per_chunk;
+    mutex lock;
+    vector<char *> chunks;
+    void *free_list;        // Singly linked through the freed blocks
+    char *next;             // Unused part of the newest chunk
+    char *chunk_end;
+    size_t live;            // Includes blocks sitting in local runs
+
+    void add_chunk();
+    void *allocate_local();     // nullptr once the thread holds runs of too many pools
+    void give_back(char *first, char *last);
+
+public:
+    static const size_t LOCAL_RUN_BLOCKS = 256;
+
+    // While one is alive, allocate() on this thread is served from a
+    // private run per pool. Unused blocks go back to their pool's free
+    // list when the outermost one ends. release_all() must not run while
+    // any thread has one open.
+    class LocalCache {
+    public:
+        LocalCache();
+        LocalCache(const LocalCache &) = delete;
+        LocalCache &operator=(const LocalCache &) = delete;
+        ~LocalCache();
+    };
+
+    ObjectPool(size_t block_size, size_t blocks_per_chunk = 4096);
+    ObjectPool(const ObjectPool &) = delete;
+    ObjectPool &operator=(const ObjectPool &) = delete;
+
+    void *allocate();
+    void deallocate(void *block);
+    // Free every chunk at once, O(chunks)
+    void release_all();
+
+    size_t live_count();
+    size_t chunk_count();
+
+    ~ObjectPool();
+};
+
+// Base for a record type whose objects come from its own ObjectPool
+// instead of the general heap: class Student : public Person,
+// public PooledRecord<Student>. A derived type of another size falls back
+// to the heap.
+template <class T>
+class PooledRecord {
+public:
+    static ObjectPool &pool()
+    {
+        // Never destroyed, records may still be freed during static destruction
+        static ObjectPool *instance = new ObjectPool(sizeof(T));
+        return *instance;
+    }
+
+    static void *operator new(size_t size)
+    {
+        if (size != sizeof(T))
+        {
+            return ::operator new(size);
+        }
+        return pool().allocate();
+    }
+
+    static void operator delete(void *block, size_t size)
+    {
+        if (size != sizeof(T))
+        {
+            ::operator delete(block);
+            return;
+        }
+        pool().deallocate(block);
+    }
+};
+#endif
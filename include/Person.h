@@ -1,49 +1,82 @@
 #ifndef PERSON_H
 #define PERSON_H
 #include <string>
+#include <atomic>
+#include <cstdint>
+#include "StringTable.h"
 using namespace std;
 
+class RecordStore;
+
+// Record type tag used for dispatch, file routing and filtering.
+// Snapshots store the numeric value, so new kinds go at the end.
+enum PersonKind : uint8_t {
+    KIND_STUDENT = 0,
+    KIND_TEACHER = 1,
+    KIND_STAFF = 2,
+    KIND_COUNT
+};
+
 class Person {
 private:
-    static int count;
+    static atomic<int> count;  // Records may be created on loader threads
 protected:
     int id;
     string name;
     int age;
-    string type;
+    PersonKind kind;
     string phone;
-    string address;
+    StringHandle address;   // Interned, addresses repeat within neighborhoods
 public:
-    Person();
+    explicit Person(PersonKind kind);
+    Person(const Person &other);
     virtual void printDetails() = 0;
     
-    // Getters
-    virtual string getName();
-    virtual int getAge();
-    virtual string printType();
-    virtual string getPhone();
-    virtual string getAddress();
+    // Getters return references into the record, copy only when needed
+    const string &getName() const;
+    int getAge() const;
+    const string &printType() const;  // Display name only, compare getKind() instead
+    PersonKind getKind() const { return kind; }
+    const string &getPhone() const;
+    const string &getAddress() const;
     static int getCount();
-    virtual int getId();
+    int getId() const;
     
-    // Setters for Person attributes
-    virtual void setName(const string& name);
-    virtual void setAge(int age);
-    virtual void setType(const string& type);
-    virtual void setPhone(const string& phone);
-    virtual void setAddress(const string& address);
-    virtual void setId(int id);
+    // Setters take their argument by value and move it into place,
+    // so passing a temporary costs no extra copy
+    void setName(string name);
+    void setAge(int age);
+    void setPhone(string phone);
+    void setAddress(string address);
+    // Interned form of the address, for loaders and scans
+    StringHandle getAddressHandle() const;
+    void setAddressHandle(StringHandle address);
+    void setId(int id);
 
-    // Setters for derived class attributes
-    virtual void setSubject(const string& subject) {}  // For Teacher
-    virtual void setDesignation(const string& designation) {}  // For Staff
+    // Setters for derived class attributes, by value like the ones above
+    virtual void setSubject(string) {}  // For Teacher
+    virtual void setDesignation(string) {}  // For Staff
+    virtual void setSubjectHandle(StringHandle) {}  // Interned forms of the two above
+    virtual void setDesignationHandle(StringHandle) {}
 
     virtual void get_common_inputs();
     virtual void get_specific_inputs() = 0;
-    static int get_person_by_id(int id, Person **data);
-    virtual int get_by_id(int id, Person **data) = 0;
+    // "Student", "Teacher" or "Staff"
+    static const char *kind_name(PersonKind kind);
+    // Parse a type name, false if unknown
+    static bool kind_from_name(const string &name, PersonKind &kind);
+    // New Student/Teacher/Staff, nullptr for an unknown kind or type name
+    static Person *create(PersonKind kind);
+    static Person *create(const string &type);
+    // Drop every Student/Teacher/Staff at once, without running destructors.
+    // Only for teardown, after the store has let go of them (RecordStore::abandon).
+    static void release_pools();
+    static int get_person_by_id(int id, RecordStore &store);
+    virtual int get_by_id(int id, RecordStore &store) = 0;
 
-    virtual bool save(Person** data, int index = -1);
+    virtual bool save(RecordStore &store, int index = -1);
+    // Copy of the record on the same pool, for copy-on-write updates
+    virtual Person *clone() const = 0;
 
     virtual ~Person();
 };
@@ -0,0 +1,89 @@
+#ifndef RECORDINDEX_H
+#define RECORDINDEX_H
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <cstdint>
+#include "Person.h"
+#include "MemoryAccounting.h"
+using namespace std;
+
+// Secondary indexes over the records of a RecordStore, by slot:
+//   name         ordered (lowercase) for case-insensitive prefix search
+//   name grams   trigram -> distinct names, for ranked matching of
+//                partial or misspelled names
+//   age          ordered, for range queries
+//   subject      hash on the interned Teacher subject
+//   designation  hash on the interned Staff designation
+// RecordStore keeps them in sync from insert/replace/erase. remove()
+// takes the values that were indexed, so a record may already have been
+// changed in place when it is re-indexed. A bulk load skips add() and
+// calls build() once at the end instead.
+class RecordIndex {
+private:
+    // Every container books its memory to MEM_INDEXES
+    template <class T>
+    using Alloc = TrackingAllocator<T, MEM_INDEXES>;
+    template <class T>
+    using List = vector<T, Alloc<T>>;
+    typedef basic_string<char, char_traits<char>, Alloc<char>> Key;
+    typedef List<int> Posting;      // Ascending
+    typedef unordered_map<StringHandle, Posting, hash<StringHandle>, equal_to<StringHandle>,
+                          Alloc<pair<const StringHandle, Posting>>> HandleIndex;
+
+    // Every distinct folded name once, with the slots that carry it.
+    // Rosters repeat names a lot, so the trigram postings refer to these
+    // groups instead of to slots and stay much shorter.
+    struct NameGroup {
+        int id;               // Position in groups, reused once the group is gone
+        List<int> slots;      // Ascending
+    };
+    // less<> compares keys with plain strings and string_views
+    typedef map<Key, NameGroup, less<>, Alloc<pair<const Key, NameGroup>>> NameIndex;
+    typedef unordered_map<uint32_t, Posting, hash<uint32_t>, equal_to<uint32_t>, Alloc<pair<const uint32_t, Posting>>>
+        GramIndex;
+    typedef map<int, Posting, less<int>, Alloc<pair<const int, Posting>>> AgeIndex;
+
+    NameIndex names;
+    List<NameIndex::iterator> name_entries;     // Per slot, names.end() if not indexed
+    List<NameIndex::iterator> groups;           // Per group id, names.end() if unused
+    List<uint8_t> gram_counts;                  // Per group id, distinct trigrams in the name
+    List<int> free_groups;
+    GramIndex grams;                            // Trigram -> group ids, ascending
+    AgeIndex ages;
+    HandleIndex subjects;
+    HandleIndex designations;
+
+    static void name_grams(string_view folded, vector<uint32_t> &out);
+    static void insert_sorted(Posting &posting, int value);
+    static bool erase_sorted(Posting &posting, int value);
+    static void erase_from(HandleIndex &index, StringHandle key, int slot);
+    static vector<int> sorted_slots(const HandleIndex &index, StringHandle key);
+    void index_grams(NameIndex::iterator entry, int id);
+
+public:
+    static string fold_case(const string &text);
+
+    void add(int slot, const Person *person, PersonKind kind, int age, StringHandle extra);
+    void remove(int slot, PersonKind kind, int age, StringHandle extra);
+    void clear();
+    // Rebuild every index from scratch over count slots, records[slot] is
+    // nullptr for a free one. Groups names and fills each posting in
+    // order once, much cheaper than count calls to add().
+    void build(const Person *const *records, const uint8_t *kinds, const int *record_ages,
+               const StringHandle *extras, int count);
+
+    // Slots in name order; limit 0 = no limit
+    vector<int> name_prefix(const string &prefix, size_t limit = 0) const;
+    // Slots whose names share at least half the query's trigrams, best
+    // match first (Jaccard similarity of the trigram sets)
+    vector<int> name_similar(const string &query, size_t limit) const;
+    // Slots in ascending order
+    vector<int> subject(StringHandle subject) const;
+    vector<int> designation(StringHandle designation) const;
+    // Slots in age order, ages min_age..max_age inclusive
+    vector<int> age_range(int min_age, int max_age) const;
+};
+#endif
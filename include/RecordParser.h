@@ -0,0 +1,83 @@
+#ifndef RECORDPARSER_H
+#define RECORDPARSER_H
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Person.h"
+using namespace std;
+
+// Table-driven parser for the backtick separated record files.
+// Lines are tokenized into string_view fields pointing into the file
+// buffer, numbers are converted with from_chars, and each string is
+// copied at most once, into the Person it belongs to or, for repeating
+// values, into the shared StringTable. A bulk loader can collect the
+// repeating values instead (deferred) and intern them in one batch, see
+// assign_interned().
+//
+// Every file shares the same leading fields:
+//   name`age`phone`address`id[`extra]
+// where extra is the subject (teachers) or designation (staff).
+const int RECORD_MAX_FIELDS = 6;
+
+struct RecordLayout {
+    const char *label;                              // Used in error messages
+    const char *path;                               // Data file to load
+    int field_count;                                // 5 or 6
+    Person *(*create)();                            // Allocates the concrete type
+    void (Person::*set_extra)(string);              // Setter for the 6th field
+    void (Person::*set_extra_handle)(StringHandle); // Same, for an interned value
+};
+
+// The three record files, in load order
+extern const RecordLayout RECORD_LAYOUTS[3];
+
+// Split a line on backticks, the last field keeps any remaining text.
+// Returns the number of fields found.
+int split_record(string_view line, string_view *fields, int max_fields);
+// Strict integer conversion, false on empty input or trailing characters
+bool parse_int(string_view text, int &value);
+// Build a record from one line, nullptr if the line is malformed.
+// With deferred, the address and extra fields are appended to it (views
+// into line) instead of being interned, and the record's handles are left
+// for assign_interned(). Without it, throws length_error when the string
+// table has no room for the line's values.
+Person *parse_record(string_view line, const RecordLayout &layout, vector<string_view> *deferred = nullptr);
+// Give records parsed with deferred their handles, handles[i] being the
+// interned deferred[i]
+void assign_interned(const vector<Person *> &records, const RecordLayout &layout, const StringHandle *handles);
+
+// Calls on_record for every well-formed line in buffer and on_error for
+// every malformed non-empty one. Handles both \n and \r\n line endings.
+template <typename OnRecord, typename OnError>
+void parse_records(string_view buffer, const RecordLayout &layout, OnRecord on_record, OnError on_error,
+                   vector<string_view> *deferred = nullptr)
+{
+    size_t start = 0;
+    while (start < buffer.size())
+    {
+        size_t end = buffer.find('\n', start);
+        if (end == string_view::npos)
+        {
+            end = buffer.size();
+        }
+        string_view line = buffer.substr(start, end - start);
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.remove_suffix(1);
+        }
+        if (!line.empty())
+        {
+            Person *person = parse_record(line, layout, deferred);
+            if (person != nullptr)
+            {
+                on_record(person);
+            }
+            else
+            {
+                on_error(line);
+            }
+        }
+        start = end + 1;
+    }
+}
+#endif
@@ -0,0 +1,147 @@
+#ifndef RECORDSTORE_H
+#define RECORDSTORE_H
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "Person.h"
+#include "RecordIndex.h"
+#include "RecordVersions.h"
+#include "MemoryAccounting.h"
+using namespace std;
+
+// Age summary produced by a column scan
+struct AgeStats {
+    int count;
+    int min_age;
+    int max_age;
+    double average;
+};
+
+// Owns every Person record in the system.
+// Records live in individually allocated objects, the store only keeps
+// pointers to them in a growable slot table. Growing the table never moves
+// a Person, so pointers handed out stay valid until the record is erased.
+// Erased slots are recycled before the table grows again.
+// An id -> slot hash index is kept in sync by insert/replace/erase, so
+// lookups by id are O(1). A record's id must be set before it is stored.
+//
+// The hot scalar fields (id, age, kind, interned address) are also kept
+// column-wise, one contiguous array per field indexed by slot, so
+// aggregate scans stream through a few bytes per record instead of
+// chasing Person pointers.
+// The columns are refreshed whenever a record is stored, so a record
+// changed in place must be saved back (Person::save) to be seen by scans.
+//
+// Loading many records at once goes between begin_bulk_load() and
+// end_bulk_load(): the secondary indexes are left alone meanwhile and
+// built once at the end, the id index stays current throughout.
+//
+// With RecordVersions attached (publish_to) the store also publishes every
+// change for lock-free readers. Records must then be changed by storing a
+// copy (Person::clone + replace), never in place, and a record that is
+// replaced or erased is handed to the versions instead of being deleted.
+class RecordStore {
+private:
+    // Slot table, columns and id index book their memory to MEM_STORE
+    template <class T>
+    using Column = vector<T, TrackingAllocator<T, MEM_STORE>>;
+    typedef unordered_map<int, int, hash<int>, equal_to<int>, TrackingAllocator<pair<const int, int>, MEM_STORE>>
+        IdIndex;
+
+    Column<Person *> slots;
+    Column<int> free_slots;
+    Column<int> free_positions;    // Per slot, its index in free_slots or -1
+    IdIndex id_index;
+    int live;
+
+    // Columns, slot_count() entries each
+    Column<int> ids;
+    Column<int> ages;
+    Column<uint8_t> kinds;      // PersonKind, or FREE_ROW for a free slot
+    Column<StringHandle> addresses;
+    Column<StringHandle> extras;   // Subject or designation, 0 for students
+
+    RecordIndex search;            // Secondary indexes, see find_by_*
+    RecordVersions *versions;      // Lock-free readers, nullptr if none
+    int bulk_depth;                // Open begin_bulk_load() calls
+
+    void index_slot(int slot);
+    bool published(int slot) const;
+    void drop(Person *person, bool was_published, int replacement_id);
+    void unindex_slot(int slot);
+    void take_free_slot(int slot);
+    void sync_row(int slot);
+
+public:
+    static constexpr uint8_t FREE_ROW = 0xFF;
+
+    RecordStore();
+    RecordStore(const RecordStore &) = delete;
+    RecordStore &operator=(const RecordStore &) = delete;
+
+    // Store a record in the first free slot (amortized O(1)), returns the slot
+    int insert(Person *person);
+    // Put a record into a specific slot, deleting whatever was there before.
+    // Storing the record already in the slot just refreshes its columns
+    // (not allowed while versions are attached).
+    void replace(int slot, Person *person);
+    // Delete the record in a slot and mark the slot free
+    bool erase(int slot);
+    // Slot holding the record with this id, or -1 (O(1) via the id index)
+    int find(int id) const;
+
+    Person *at(int slot) const;
+    int size() const;        // Number of live records
+    int slot_count() const;  // Number of slots, used or free
+    bool empty() const;
+    void reserve(int count);
+    // Defer the secondary indexes until the matching end_bulk_load(), which
+    // builds them in one pass. Calls nest, the outermost end builds. The
+    // find_by_* queries are not answered in between.
+    void begin_bulk_load();
+    void end_bulk_load();
+    void clear();            // Delete every record
+    // Forget every record without deleting it. Used at exit together with
+    // Person::release_pools(), which frees the records in bulk.
+    void abandon();
+
+    // Publish every change to versions from now on, seeding it with the
+    // current records; nullptr detaches and clears the old versions.
+    // No ReadView may be open on the old versions.
+    void publish_to(RecordVersions *versions);
+
+    // Queries answered from the secondary indexes, results are slots
+    vector<int> find_by_name_prefix(const string &prefix, size_t limit = 0) const;  // Case-insensitive, name order
+    vector<int> find_by_name(const string &query, size_t limit = 20) const;  // Partial or misspelled, best first
+    vector<int> find_by_subject(const string &subject) const;          // Teachers, exact match
+    vector<int> find_by_designation(const string &designation) const;  // Staff, exact match
+    vector<int> find_by_age(int min_age, int max_age, PersonKind kind = KIND_COUNT) const;  // Age order
+
+    // Raw columns for scans, slot_count() entries each
+    const int *id_column() const;
+    const int *age_column() const;
+    const uint8_t *kind_column() const;
+    const StringHandle *address_column() const;  // Handles into StringTable::shared()
+    // Aggregates computed from the columns only
+    void count_by_kind(int counts[KIND_COUNT]) const;
+    AgeStats age_stats(PersonKind kind = KIND_COUNT) const;  // KIND_COUNT = every kind
+
+    // Iterates over live records only, skipping free slots
+    class const_iterator {
+    private:
+        const RecordStore *store;
+        int slot;
+        void skip_free();
+    public:
+        const_iterator(const RecordStore *store, int slot);
+        Person *operator*() const;
+        const_iterator &operator++();
+        bool operator!=(const const_iterator &other) const;
+        int index() const { return slot; }
+    };
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    ~RecordStore();
+};
+#endif
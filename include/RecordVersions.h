@@ -0,0 +1,113 @@
+#ifndef RECORDVERSIONS_H
+#define RECORDVERSIONS_H
+#include <atomic>
+#include <deque>
+#include <cstdint>
+#include "Person.h"
+#include "MemoryAccounting.h"
+using namespace std;
+
+// Point-in-time views of the records for readers that take no lock.
+//
+// Every id has a chain of versions, newest first. A writer never changes a
+// published record: it stores a copy (Person::clone) and publishes that as
+// the new version, or publishes a tombstone when the record is deleted.
+// Each publish advances a global epoch. A reader pins the current epoch in
+// a ReadView and sees, for every id, the newest version published at or
+// before it, so a view is consistent across ids and unaffected by later
+// writes.
+//
+// A superseded version is retired with the epoch that replaced it and
+// deleted, record included, once no pinned view is older than that epoch
+// (epoch-based reclamation). A long-lived view holds back reclamation, not
+// the writer.
+//
+// Readers may run on any thread. publish/reclaim/clear are for a single
+// writer at a time, the caller serializes them. Tombstones are kept until
+// their id is reused or clear() runs.
+class RecordVersions {
+private:
+    struct Version {
+        const Person *record;       // nullptr for a tombstone
+        uint64_t since;             // Epoch it was published in
+        atomic<Version *> older;
+
+        Version(const Person *record, uint64_t since, Version *older) : record(record), since(since), older(older) {}
+
+        static void *operator new(size_t size)
+        {
+            void *block = ::operator new(size);
+            MemoryAccounting::allocated(MEM_VERSIONS, size);
+            return block;
+        }
+        static void operator delete(void *block, size_t size)
+        {
+            MemoryAccounting::released(MEM_VERSIONS, size);
+            ::operator delete(block);
+        }
+    };
+    typedef atomic<Version *> Head;
+
+    struct Retired {
+        Version *newer;             // Version that replaced it
+        Version *version;
+        uint64_t until;             // Invisible to views pinned at or after this
+    };
+
+    // Sized for the cache line so readers pinning at once do not contend
+    struct alignas(64) ReaderSlot {
+        atomic<uint64_t> pinned;    // Pinned epoch + 1, 0 when free
+    };
+
+    static const int CHUNK_BITS = 14;
+    static const uint32_t CHUNK_SIZE = 1u << CHUNK_BITS;
+    static const uint32_t MAX_CHUNKS = 1u << (31 - CHUNK_BITS);   // Every non-negative int id
+    static const int READER_SLOTS = 64;
+
+    atomic<Head *> *chunks;         // MAX_CHUNKS entries, filled on demand, never moved
+    atomic<uint64_t> clock;
+    ReaderSlot readers[READER_SLOTS];
+    deque<Retired, TrackingAllocator<Retired, MEM_VERSIONS>> retired;   // Oldest first, writer only
+
+    const Person *find(int id, uint64_t epoch) const;
+
+public:
+    // Pins the current epoch for its lifetime. Records it returns stay
+    // valid and unchanged until the view is destroyed.
+    class ReadView {
+    private:
+        RecordVersions &versions;
+        int slot;
+        uint64_t epoch;
+    public:
+        explicit ReadView(RecordVersions &versions);
+        ReadView(const ReadView &) = delete;
+        ReadView &operator=(const ReadView &) = delete;
+
+        // Record with this id as of the pinned epoch, nullptr if there was none
+        const Person *find(int id) const { return versions.find(id, epoch); }
+        uint64_t getEpoch() const { return epoch; }
+
+        ~ReadView();
+    };
+
+    RecordVersions();
+    RecordVersions(const RecordVersions &) = delete;
+    RecordVersions &operator=(const RecordVersions &) = delete;
+
+    // Make record (nullptr to delete) the current version of id in a new
+    // epoch. The previous version's record now belongs to this object and
+    // is deleted once no view can see it. Ids below 0 are ignored.
+    void publish(int id, const Person *record);
+    // Delete retired versions no view can see any more, returns how many
+    size_t reclaim();
+    // Drop every version. The current records are left to their owner,
+    // retired ones are deleted. No view may be open.
+    void clear();
+
+    uint64_t getEpoch() const;
+    size_t retired_count() const;   // Versions waiting for readers to move on
+
+    ~RecordVersions();
+};
+#endif
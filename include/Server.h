@@ -0,0 +1,82 @@
+#ifndef SERVER_H
+#define SERVER_H
+#include <string>
+#include <vector>
+#include <set>
+#include <sstream>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <atomic>
+#include "RecordStore.h"
+#include "RecordVersions.h"
+#include "IdAllocator.h"
+#include "Journal.h"
+#include "BatchRunner.h"
+using namespace std;
+
+const char SERVER_SOCKET_PATH[] = "../data/sms.sock";
+
+// Server mode: sms --serve [socket]
+// One process owns the roster and answers several front-desk clients over
+// a local Unix socket, one thread per connection.
+//
+// A request is one line: the batch commands (add, modify, delete, get,
+// commit, see BatchRunner) plus these queries:
+//   find`name[`limit]          ranked name search (default limit 20)
+//   prefix`text[`limit]        names starting with text
+//   subject`name[`limit]       designation`name[`limit]
+//   age`min`max[`limit]        (default limit 100 for the list queries)
+//   stats                      OK <records> <highest id>
+//   quit                       close the connection
+// Every reply is zero or more record lines (get's format) followed by one
+// status line, "OK ..." or "ERR message". Requests may be pipelined.
+//
+// get takes no lock: it reads the record as of a pinned epoch from
+// RecordVersions, which the store publishes every change to while the
+// server runs. The index queries share a reader-writer lock, add/modify/
+// delete hold it exclusively only while they change the store and append
+// to the journal.
+// The fsync that makes the change durable runs after the lock is released,
+// and writers waiting at the same time share one fsync, so queries never
+// wait for the disk. A change is acknowledged once it is durable.
+class Server {
+private:
+    RecordStore &store;
+    IdAllocator &ids;
+    Journal &journal;
+    string path;
+    int listen_fd;
+    atomic<bool> stopping;
+
+    shared_mutex records;       // Shared by queries, exclusive for changes
+    mutex durability;           // Serializes journal fsyncs and compaction
+    ostringstream update_out;
+    BatchRunner updates;        // Applies changes, used under records only
+    RecordVersions versions;    // Lock-free view for get, attached by run()
+
+    mutex clients_lock;
+    condition_variable clients_done;
+    set<int> clients;           // Open connections
+
+    void serve_client(int fd);
+    void handle(const string &line, string &reply);
+    void query(const vector<string> &fields, string &reply);
+    void update(const string &line, string &reply);
+    void compact();
+
+public:
+    Server(RecordStore &store, IdAllocator &ids, Journal &journal, const string &path = SERVER_SOCKET_PATH);
+    Server(const Server &) = delete;
+    Server &operator=(const Server &) = delete;
+
+    // Create and bind the socket, false if it cannot be used
+    bool start();
+    // Accept clients until stop(), then wait for open connections to close
+    void run();
+    // Ask run() to finish; only sets a flag, safe from a signal handler
+    void stop();
+
+    ~Server();
+};
+#endif
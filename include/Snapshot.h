@@ -0,0 +1,66 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+#include <string>
+#include <cstdint>
+#include "RecordStore.h"
+#include "IdAllocator.h"
+using namespace std;
+
+// Binary snapshot of the whole roster.
+// Layout (host byte order):
+//   SnapshotHeader
+//   SnapshotRecord[record_count]
+//   SnapshotString[string_count]   interned values, a record's address and
+//                                  extra are indexes into this table
+//   int32_t[free_count]            IdAllocator free list, next ID last
+//   string heap (heap_size bytes, strings are offset/length into it)
+// The file is memory mapped on load, so opening it costs one pass over
+// fixed-width records with no text parsing, and each distinct interned
+// value is interned once rather than once per record. The backtick text
+// files stay the import/export format. Version 1 files (every field in
+// the heap, no free list) are still read.
+const uint32_t SNAPSHOT_VERSION = 2;
+const char SNAPSHOT_PATH[] = "../data/roster.bin";
+// Header flag: the text files were written together with this snapshot
+// and hold the same records (sms --compact)
+const uint32_t SNAPSHOT_TEXT_CURRENT = 1;
+
+struct SnapshotHeader {
+    char magic[4];          // "SMSB"
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t record_size;
+    uint64_t record_count;
+    uint64_t heap_size;
+    int32_t high_water;     // Highest ID handed out when the snapshot was taken
+    uint32_t string_count;  // Version 1 ends here (reserved, 0)
+    uint32_t free_count;
+    uint32_t flags;         // SNAPSHOT_TEXT_CURRENT
+};
+
+struct SnapshotString {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct SnapshotRecord {
+    int32_t id;
+    int32_t age;
+    uint8_t kind;           // PersonKind
+    uint8_t reserved[3];
+    uint32_t address;       // Index into the string table
+    uint32_t extra;         // Subject for teachers, designation for staff, 0 for students
+    SnapshotString name;
+    SnapshotString phone;
+};
+
+bool save_snapshot(const RecordStore &store, const IdAllocator &ids, const string &path = SNAPSHOT_PATH,
+                   bool text_current = false);
+bool read_snapshot(RecordStore &store, IdAllocator &ids, const string &path = SNAPSHOT_PATH);
+// True when the snapshot exists and is not older than the text files
+bool snapshot_is_current(const string &path = SNAPSHOT_PATH);
+// True when a snapshot exists that may hold changes the text files lack:
+// it was not written by sms --compact, or its header cannot be read.
+// Loading the text files instead would then lose those changes.
+bool snapshot_ahead_of_text(const string &path = SNAPSHOT_PATH);
+#endif
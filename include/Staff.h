@@ -1,23 +1,28 @@
 #ifndef STAFF_H
 #define STAFF_H
 #include "Person.h"
+#include "ObjectPool.h"
 
-class Staff : public Person
+class Staff : public Person, public PooledRecord<Staff>
 {
 private:
-    string designation;
-    static int count;
+    StringHandle designation;   // Interned, a handful of distinct designations
+    static atomic<int> count;  // Records may be created on loader threads
 
 public:
     Staff();
+    Staff(const Staff &other);
     void printDetails() override;
-    int get_by_id(int id, Person **data) override;
-    bool save(Person **data, int index = -1);
+    int get_by_id(int id, RecordStore &store) override;
+    bool save(RecordStore &store, int index = -1);
+    Person *clone() const override;
     static int getCount();
+
+    const string &getDesignation() const;
+    StringHandle getDesignationHandle() const;
     
-    virtual string getDesignation();
-    
-    void setDesignation(const string& designation) override;
+    void setDesignation(string designation) override;
+    void setDesignationHandle(StringHandle designation) override;
     virtual void get_specific_inputs() override;
     virtual ~Staff();
 };
@@ -0,0 +1,77 @@
+#ifndef STRINGTABLE_H
+#define STRINGTABLE_H
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+using namespace std;
+
+// 32-bit reference to a value stored in a StringTable
+typedef uint32_t StringHandle;
+
+// Interning table for field values that repeat across records
+// (addresses, subjects, designations). Each distinct value is stored
+// once and records keep a 4 byte handle instead of a 32 byte string plus
+// its heap buffer. Handle 0 is always the empty string.
+//
+// Values live in fixed-size chunks that never move, so get() needs no
+// lock and the returned reference stays valid for the table's lifetime.
+// intern() is safe to call from the parallel loader threads, which intern
+// a whole chunk's values in one call so they take the lock once per chunk
+// instead of once per field. Values are never removed: a value no record
+// uses any more keeps its slot. Once the table holds capacity values, a
+// new one makes intern() throw length_error, so the caller can refuse the
+// record instead of storing it with a blank field.
+class StringTable {
+private:
+    static const int CHUNK_BITS = 12;
+    static const uint32_t CHUNK_SIZE = 1u << CHUNK_BITS;
+    static const uint32_t MAX_CHUNKS = 1u << 16;   // 268M distinct values
+
+    vector<string *> chunks;                       // MAX_CHUNKS entries, filled on demand
+    uint32_t capacity;
+    uint32_t count;
+    size_t value_bytes;
+    unordered_map<string_view, StringHandle> index; // Views into the stored values
+    mutable mutex lock;
+
+    StringHandle store(string &&value);
+
+public:
+    static const uint32_t MAX_VALUES = CHUNK_SIZE * MAX_CHUNKS - 1;
+
+    // capacity: most values it stores besides the empty string, up to MAX_VALUES
+    explicit StringTable(uint32_t capacity = MAX_VALUES);
+    StringTable(const StringTable &) = delete;
+    StringTable &operator=(const StringTable &) = delete;
+
+    // Handle of an equal value already stored, or of a new copy.
+    // Throws length_error when the value is new and the table is full.
+    StringHandle intern(string_view value);
+    // Same, but moves the value in when it is new
+    StringHandle intern(string &&value);
+    // handles[i] = intern(values[i]) for count values, under one lock.
+    // Values before the one that did not fit stay interned.
+    void intern(const string_view *values, size_t count, StringHandle *handles);
+    // Make room in the lookup for count more values, so a load that knows
+    // how many it will add does not rehash on the way
+    void reserve(size_t count);
+    // Handle of a stored value without adding it, false if not stored
+    bool find(string_view value, StringHandle &handle) const;
+
+    const string &get(StringHandle handle) const
+    {
+        return chunks[handle >> CHUNK_BITS][handle & (CHUNK_SIZE - 1)];
+    }
+
+    size_t size() const;    // Distinct values, including the empty string
+    size_t bytes() const;   // Approximate memory held by the table
+
+    // Table shared by every record
+    static StringTable &shared();
+
+    ~StringTable();
+};
+#endif
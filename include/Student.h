@@ -1,17 +1,19 @@
 #ifndef STUDENT_H
 #define STUDENT_H
 #include "Person.h"
+#include "ObjectPool.h"
 
-class Student : public Person {
+class Student : public Person, public PooledRecord<Student> {
 private:
-    static int count;
+    static atomic<int> count;  // Records may be created on loader threads
 public:
     Student();
+    Student(const Student &other);
     void printDetails() override;
-    int get_by_id(int id, Person **data) override;
-    bool save(Person **data, int index = -1);
+    int get_by_id(int id, RecordStore &store) override;
+    bool save(RecordStore &store, int index = -1);
+    Person *clone() const override;
     static int getCount();
-    
 
     void get_specific_inputs() override;
 
@@ -1,21 +1,26 @@
 #ifndef TEACHER_H
 #define TEACHER_H
 #include "Person.h"
+#include "ObjectPool.h"
 
-class Teacher : public Person {
+class Teacher : public Person, public PooledRecord<Teacher> {
 private:
-    string subject;
-    static int count;
+    StringHandle subject;   // Interned, a handful of distinct subjects
+    static atomic<int> count;  // Records may be created on loader threads
 public:
     Teacher();
+    Teacher(const Teacher &other);
     void printDetails() override;
-    int get_by_id(int id, Person **data) override;
-    bool save(Person **data, int index = -1);
+    int get_by_id(int id, RecordStore &store) override;
+    bool save(RecordStore &store, int index = -1);
+    Person *clone() const override;
     static int getCount();
+
+    const string &getSubject() const;
+    StringHandle getSubjectHandle() const;
     
-    string getSubject() const;
-    
-    void setSubject(const string& subject) override;
+    void setSubject(string subject) override;
+    void setSubjectHandle(StringHandle subject) override;
 
     virtual void get_specific_inputs() override;
     
@@ -0,0 +1,40 @@
+#ifndef TERMINAL_H
+#define TERMINAL_H
+#include <ostream>
+using namespace std;
+
+// In-process terminal control: clearing, colors and cursor movement.
+// Uses ANSI/VT escape sequences, which are written into the caller's
+// stream so they travel in the same frame as the text. Legacy Windows
+// consoles without VT support fall back to the console API.
+class Terminal {
+private:
+    static bool vt_enabled;
+    static bool initialized;
+
+public:
+    // A full main menu redraw (clear + box + prompt) must fit in this budget
+    static const int REDRAW_BUDGET_MICROS = 1000;
+
+    // Detects / enables VT processing, safe to call more than once
+    static void init();
+    static bool supports_vt();
+
+    static void clear_screen(ostream &out);
+    static void move_cursor(ostream &out, int row, int col);   // 1-based
+    static void set_color(ostream &out, int color);             // Utility::Colors value
+    static void reset_color(ostream &out);
+
+    // Wait for one key press without echo, like conio's getch() on every
+    // platform. Reads a plain character when input is not a terminal.
+    // Returns EOF at end of input.
+    static int read_key();
+
+    // Console API fallbacks, used only when supports_vt() is false.
+    // The caller must flush pending output first.
+    static void legacy_clear_screen();
+    static void legacy_set_color(int color);
+
+    Terminal() = delete;
+};
+#endif
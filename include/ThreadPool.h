@@ -0,0 +1,19 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+#include <functional>
+using namespace std;
+
+// Runs a batch of independent tasks on worker threads.
+// Workers pull task indexes from a shared counter, so uneven tasks balance
+// out. run() returns once every task has finished. Tasks must write their
+// results into their own slot, the caller merges them in index order.
+class ThreadPool {
+private:
+    int workers;
+
+public:
+    ThreadPool(int workers = 0);    // 0 = one per hardware thread
+    void run(int task_count, const function<void(int)> &task);
+    int getWorkers() const;
+};
+#endif
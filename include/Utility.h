@@ -3,6 +3,7 @@
 
 #include <string>
 #include <vector>
+#include <ostream>
 #ifdef _WIN32
 #include <windows.h>
 #endif
@@ -10,6 +11,11 @@ using namespace std;
 
 class Utility {
 public:
+    // Output is composed in a frame buffer and written with one syscall.
+    // Wrap several calls in begin_frame()/end_frame() to emit them together.
+    static ostream &out();
+    static void begin_frame();
+    static void end_frame();
     static void print_line(int);
     static void print_dashed_line(int);
     static void print_header(const string& title);
@@ -17,10 +23,16 @@ public:
     static void print_success_message(const string& message);
     static void print_error_message(const string& message);
     static void print_info_box(const string& message);
+    static void clear_screen();
     static void set_console_color(int color);
     static void reset_console_color();
     static int take_integer_input(int min, int max, string prompt);
     static string take_phone_input();
+    // Validation rules shared by the interactive prompts and bulk input
+    static bool is_valid_phone(const string &phone);
+    static bool is_valid_age(int age);
+    static const int MIN_AGE = 18;
+    static const int MAX_AGE = 50;
     static string take_string_input(string prompt);
     Utility() = delete;
 
@@ -0,0 +1,279 @@
+#include "BatchRunner.h"
+#include "RecordParser.h"
+#include "Utility.h"
+#include "Teacher.h"
+#include "Staff.h"
+#include "Metrics.h"
+
+#include <climits>
+#include <stdexcept>
+
+using namespace std;
+
+const int BATCH_MAX_FIELDS = 7;
+
+BatchRunner::BatchRunner(RecordStore &store, IdAllocator &ids, Journal &journal, ostream &out, ostream &err, int commit_every)
+    : store(store), ids(ids), journal(journal), out(out), err(err), commit_every(commit_every),
+      succeeded(0), failed(0)
+{
+    // Group commit: sync every commit_every appends, or only on commit/end
+    journal.setSyncEvery(commit_every > 0 ? commit_every : INT_MAX);
+}
+
+static bool fill_fields(Person *person, const vector<string> &fields, size_t first, bool keep_empty, string &error)
+{
+    const string &name = fields[first];
+    const string &age_text = fields[first + 1];
+    const string &phone = fields[first + 2];
+    const string &address = fields[first + 3];
+
+    for (size_t i = first; i < fields.size(); i++)
+    {
+        // The journal and data files use backticks and newlines as separators
+        if (fields[i].find_first_of("`\n") != string::npos)
+        {
+            error = "fields cannot contain backticks or line breaks";
+            return false;
+        }
+    }
+
+    int age = person->getAge();
+    if (!(keep_empty && age_text.empty()))
+    {
+        if (!parse_int(age_text, age) || !Utility::is_valid_age(age))
+        {
+            error = "age must be a number between " + to_string(Utility::MIN_AGE) + " and " + to_string(Utility::MAX_AGE);
+            return false;
+        }
+    }
+    if (!(keep_empty && phone.empty()) && !Utility::is_valid_phone(phone))
+    {
+        error = "phone must be 11 digits starting with 03";
+        return false;
+    }
+    if ((!keep_empty && name.empty()) || (!keep_empty && address.empty()))
+    {
+        error = "name and address cannot be empty";
+        return false;
+    }
+
+    if (!name.empty())
+        person->setName(name);
+    person->setAge(age);
+    if (!phone.empty())
+        person->setPhone(phone);
+    if (!address.empty())
+        person->setAddress(address);
+    if (fields.size() > first + 4 && !fields[first + 4].empty())
+    {
+        // Base class setters ignore the field for the other types
+        person->setSubject(fields[first + 4]);
+        person->setDesignation(fields[first + 4]);
+    }
+    return true;
+}
+
+// fill_fields, refusing the record when the string table has no room
+// for one of its values
+static bool fill_common(Person *person, const vector<string> &fields, size_t first, bool keep_empty, string &error)
+{
+    try
+    {
+        return fill_fields(person, fields, first, keep_empty, error);
+    }
+    catch (const length_error &e)
+    {
+        error = e.what();
+        return false;
+    }
+}
+
+bool BatchRunner::run_add(const vector<string> &fields, string &error)
+{
+    // add`type`name`age`phone`address[`extra]
+    if (fields.size() < 6)
+    {
+        error = "add needs type, name, age, phone and address";
+        return false;
+    }
+    Person *person = Person::create(fields[1]);
+    if (person == nullptr)
+    {
+        error = "unknown type '" + fields[1] + "'";
+        return false;
+    }
+    bool needs_extra = person->getKind() != KIND_STUDENT;
+    if (needs_extra != (fields.size() == 7) || (needs_extra && fields[6].empty()))
+    {
+        error = needs_extra ? fields[1] + " needs a subject/designation field" : "Student takes 5 fields";
+        delete person;
+        return false;
+    }
+    if (!fill_common(person, fields, 2, false, error))
+    {
+        delete person;
+        return false;
+    }
+
+    person->setId(ids.allocate());
+    person->save(store);
+    journal.log_add(person);
+    out << "added " << person->printType() << " " << person->getId() << '\n';
+    return true;
+}
+
+bool BatchRunner::run_modify(const vector<string> &fields, string &error)
+{
+    // modify`id`name`age`phone`address[`extra]
+    int id;
+    if (fields.size() < 6 || !parse_int(fields[1], id))
+    {
+        error = "modify needs id, name, age, phone and address";
+        return false;
+    }
+    int index = store.find(id);
+    if (index == -1)
+    {
+        error = "no person with ID " + fields[1];
+        return false;
+    }
+    // Change a copy and store that, a reader holding the old record
+    // (server mode, RecordVersions) keeps seeing it unchanged
+    Person *person = store.at(index)->clone();
+    if (!fill_common(person, fields, 2, true, error))
+    {
+        delete person;
+        return false;
+    }
+    person->save(store, index);
+    journal.log_modify(person);
+    out << "modified " << id << '\n';
+    return true;
+}
+
+bool BatchRunner::run_delete(const vector<string> &fields, string &error)
+{
+    int id;
+    if (fields.size() != 2 || !parse_int(fields[1], id))
+    {
+        error = "delete needs an id";
+        return false;
+    }
+    if (!store.erase(store.find(id)))
+    {
+        error = "no person with ID " + fields[1];
+        return false;
+    }
+    ids.release(id);
+    journal.log_delete(id);
+    out << "deleted " << id << '\n';
+    return true;
+}
+
+bool BatchRunner::run_get(const vector<string> &fields, string &error)
+{
+    int id;
+    if (fields.size() != 2 || !parse_int(fields[1], id))
+    {
+        error = "get needs an id";
+        return false;
+    }
+    Person *person = store.at(store.find(id));
+    if (person == nullptr)
+    {
+        Metrics::count(COUNTER_LOOKUP_MISSES);
+        error = "no person with ID " + fields[1];
+        return false;
+    }
+    write_record(out, person);
+    return true;
+}
+
+void BatchRunner::write_record(ostream &out, const Person *person)
+{
+    out << person->getId() << "`" << person->printType() << "`" << person->getName() << "`"
+        << person->getAge() << "`" << person->getPhone() << "`" << person->getAddress();
+    if (person->getKind() == KIND_TEACHER)
+        out << "`" << static_cast<const Teacher *>(person)->getSubject();
+    else if (person->getKind() == KIND_STAFF)
+        out << "`" << static_cast<const Staff *>(person)->getDesignation();
+    out << '\n';
+}
+
+// Counts the change commands that were refused
+static bool counted(bool applied)
+{
+    if (!applied)
+    {
+        Metrics::count(COUNTER_REJECTED_CHANGES);
+    }
+    return applied;
+}
+
+bool BatchRunner::execute(const string &line, string &error)
+{
+    string_view views[BATCH_MAX_FIELDS];
+    int count = split_record(line, views, BATCH_MAX_FIELDS);
+    vector<string> fields(views, views + count);
+    const string &command = fields[0];
+
+    if (command == "add")
+    {
+        ScopedTimer timer(TIMER_ADD);
+        return counted(run_add(fields, error));
+    }
+    else if (command == "modify")
+    {
+        ScopedTimer timer(TIMER_MODIFY);
+        return counted(run_modify(fields, error));
+    }
+    else if (command == "delete")
+    {
+        ScopedTimer timer(TIMER_DELETE);
+        return counted(run_delete(fields, error));
+    }
+    else if (command == "get")
+    {
+        ScopedTimer timer(TIMER_LOOKUP);
+        return run_get(fields, error);
+    }
+    else if (command == "commit")
+    {
+        return journal.sync();
+    }
+    error = "unknown command '" + command + "'";
+    return false;
+}
+
+int BatchRunner::run(istream &in)
+{
+    string line;
+    int line_number = 0;
+    while (getline(in, line))
+    {
+        line_number++;
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        string error;
+        if (execute(line, error))
+        {
+            succeeded++;
+        }
+        else
+        {
+            failed++;
+            err << "line " << line_number << ": " << error << endl;
+        }
+    }
+    journal.sync();
+    return failed;
+}
+
+int BatchRunner::getSucceeded() const { return succeeded; }
+int BatchRunner::getFailed() const { return failed; }
@@ -0,0 +1,380 @@
+#include "CsvPipeline.h"
+#include "RecordParser.h"
+#include "Utility.h"
+#include "Teacher.h"
+#include "Staff.h"
+
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+// getline that keeps at most limit characters, the rest of the line is
+// read and dropped (overflow set)
+static bool read_line(istream &in, string &line, size_t limit, bool &overflow)
+{
+    line.clear();
+    overflow = false;
+    streambuf *buffer = in.rdbuf();
+    bool any = false;
+    for (int ch = buffer->sbumpc(); ch != char_traits<char>::eof(); ch = buffer->sbumpc())
+    {
+        any = true;
+        if (ch == '\n')
+        {
+            return true;
+        }
+        if (line.size() < limit)
+            line += (char)ch;
+        else
+            overflow = true;
+    }
+    if (!any)
+    {
+        in.setstate(ios::eofbit | ios::failbit);
+    }
+    return any;
+}
+
+bool read_csv_row(istream &in, vector<string> &fields, string &line, long long &line_number, string &error)
+{
+    fields.clear();
+    error.clear();
+    bool overflow;
+    if (!read_line(in, line, CSV_MAX_ROW_BYTES, overflow))
+    {
+        return false;
+    }
+    line_number++;
+
+    string field;
+    bool quoted = false;
+    size_t row_bytes = 0;
+    while (true)
+    {
+        row_bytes += line.size();
+        if (overflow)
+        {
+            fields.clear();
+            error = "row longer than " + to_string(CSV_MAX_ROW_BYTES) + " bytes" +
+                    (quoted ? " (unclosed quote?)" : "") + ", skipped";
+            return true;
+        }
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        for (size_t i = 0; i < line.size(); i++)
+        {
+            char ch = line[i];
+            if (quoted)
+            {
+                if (ch == '"' && i + 1 < line.size() && line[i + 1] == '"')
+                {
+                    field += '"';
+                    i++;
+                }
+                else if (ch == '"')
+                {
+                    quoted = false;
+                }
+                else
+                {
+                    field += ch;
+                }
+            }
+            else if (ch == '"')
+            {
+                quoted = true;
+            }
+            else if (ch == ',')
+            {
+                fields.push_back(field);
+                field.clear();
+            }
+            else
+            {
+                field += ch;
+            }
+        }
+        // A quoted field may continue on the next line, within the row limit
+        if (quoted && read_line(in, line, CSV_MAX_ROW_BYTES - row_bytes, overflow))
+        {
+            line_number++;
+            field += '\n';
+            continue;
+        }
+        break;
+    }
+    fields.push_back(field);
+    return true;
+}
+
+void write_csv_field(ostream &out, const string &field)
+{
+    if (field.find_first_of(",\"\n\r") == string::npos)
+    {
+        out << field;
+        return;
+    }
+    out << '"';
+    for (char ch : field)
+    {
+        if (ch == '"')
+            out << '"';
+        out << ch;
+    }
+    out << '"';
+}
+
+static string trim(const string &text)
+{
+    size_t first = text.find_first_not_of(" \t");
+    if (first == string::npos)
+    {
+        return "";
+    }
+    size_t last = text.find_last_not_of(" \t");
+    return text.substr(first, last - first + 1);
+}
+
+CsvImporter::CsvImporter(RecordStore &store, IdAllocator &ids, Journal &journal, ostream &err, int batch_size)
+    : store(store), ids(ids), journal(journal), err(err), batch_size(batch_size < 1 ? 1 : batch_size)
+{
+    // One journal sync per batch instead of one per row
+    journal.setSyncEvery(INT_MAX);
+    batch.reserve(this->batch_size);
+}
+
+void CsvImporter::setDefaultType(const string &type) { default_type = type; }
+
+bool CsvImporter::map_header(const vector<string> &header)
+{
+    static const char *const NAMES[COLUMN_COUNT] = {"type", "name", "age", "phone", "address", "id", "subject", "designation"};
+    for (int column = 0; column < COLUMN_COUNT; column++)
+    {
+        columns[column] = -1;
+    }
+    for (size_t i = 0; i < header.size(); i++)
+    {
+        string name = trim(header[i]);
+        transform(name.begin(), name.end(), name.begin(), ::tolower);
+        for (int column = 0; column < COLUMN_COUNT; column++)
+        {
+            if (name == NAMES[column])
+            {
+                columns[column] = (int)i;
+            }
+        }
+    }
+
+    bool valid = true;
+    for (int column : {NAME, AGE, PHONE, ADDRESS})
+    {
+        if (columns[column] == -1)
+        {
+            err << "CSV header is missing the '" << NAMES[column] << "' column." << endl;
+            valid = false;
+        }
+    }
+    if (columns[TYPE] == -1 && default_type.empty())
+    {
+        err << "CSV header has no 'type' column and no default type was given." << endl;
+        valid = false;
+    }
+    return valid;
+}
+
+Person *CsvImporter::build_row(const vector<string> &fields, string &error)
+{
+    auto field = [&](int column) -> string
+    {
+        int index = columns[column];
+        return (index >= 0 && index < (int)fields.size()) ? trim(fields[index]) : string();
+    };
+
+    string type = columns[TYPE] == -1 ? default_type : field(TYPE);
+    string name = field(NAME);
+    string age_text = field(AGE);
+    string phone = field(PHONE);
+    string address = field(ADDRESS);
+    string id_text = field(ID);
+    PersonKind kind = KIND_STUDENT;
+    bool known_kind = Person::kind_from_name(type, kind);
+    string extra = kind == KIND_TEACHER ? field(SUBJECT) : field(DESIGNATION);
+
+    int age, id = 0;
+    if (!known_kind)
+    {
+        error = "unknown type '" + type + "'";
+    }
+    else if (name.empty() || address.empty())
+    {
+        error = "name and address cannot be empty";
+    }
+    else if (!parse_int(age_text, age) || !Utility::is_valid_age(age))
+    {
+        error = "age must be a number between " + to_string(Utility::MIN_AGE) + " and " + to_string(Utility::MAX_AGE);
+    }
+    else if (!Utility::is_valid_phone(phone))
+    {
+        error = "phone must be 11 digits starting with 03";
+    }
+    else if (kind != KIND_STUDENT && extra.empty())
+    {
+        error = string(kind == KIND_TEACHER ? "subject" : "designation") + " cannot be empty";
+    }
+    else if ((name + address + extra).find_first_of("`\n") != string::npos)
+    {
+        // The data files use backticks and newlines as separators
+        error = "fields cannot contain backticks or line breaks";
+    }
+    else if (!id_text.empty() && (!parse_int(id_text, id) || id <= 0))
+    {
+        error = "id must be a positive number";
+    }
+    else if (id != 0 && store.find(id) != -1)
+    {
+        error = "ID " + id_text + " already exists";
+    }
+    if (!error.empty())
+    {
+        return nullptr;
+    }
+
+    Person *person = Person::create(kind);
+    person->setName(move(name));
+    person->setAge(age);
+    person->setPhone(move(phone));
+    try
+    {
+        person->setAddress(move(address));
+        person->setSubject(extra);
+        person->setDesignation(move(extra));
+    }
+    catch (const length_error &e)
+    {
+        // No room left in the string table for a new value
+        error = e.what();
+        delete person;
+        return nullptr;
+    }
+    if (id != 0)
+    {
+        ids.seed(id);
+    }
+    else
+    {
+        id = ids.allocate();
+    }
+    person->setId(id);
+    return person;
+}
+
+void CsvImporter::flush_batch()
+{
+    if (batch.empty())
+    {
+        return;
+    }
+    store.reserve(store.slot_count() + (int)batch.size());
+    for (Person *person : batch)
+    {
+        store.insert(person);
+        journal.log_add(person);
+    }
+    journal.sync();
+    batch.clear();
+}
+
+CsvImportResult CsvImporter::run(istream &in)
+{
+    CsvImportResult result = {0, 0, 0, false};
+    vector<string> fields;
+    string line;
+    string error;
+    long long line_number = 0;
+
+    if (!read_csv_row(in, fields, line, line_number, error) || !error.empty() || !map_header(fields))
+    {
+        err << "CSV import aborted: no usable header row." << endl;
+        result.aborted = true;
+        return result;
+    }
+
+    while (read_csv_row(in, fields, line, line_number, error))
+    {
+        if (error.empty() && fields.size() == 1 && trim(fields[0]).empty())
+        {
+            continue;
+        }
+        result.rows++;
+        Person *person = error.empty() ? build_row(fields, error) : nullptr;
+        if (person == nullptr)
+        {
+            result.failed++;
+            err << "line " << line_number << ", row " << result.rows << ": " << error << endl;
+            continue;
+        }
+        // IDs in the pending batch are not in the store yet
+        for (Person *pending : batch)
+        {
+            if (pending->getId() == person->getId())
+            {
+                error = "ID " + to_string(person->getId()) + " appears twice";
+                break;
+            }
+        }
+        if (!error.empty())
+        {
+            delete person;
+            result.failed++;
+            err << "line " << line_number << ", row " << result.rows << ": " << error << endl;
+            continue;
+        }
+        batch.push_back(person);
+        result.imported++;
+        if ((int)batch.size() >= batch_size)
+        {
+            flush_batch();
+        }
+    }
+    flush_batch();
+    return result;
+}
+
+CsvImporter::~CsvImporter()
+{
+    flush_batch();
+}
+
+long long export_csv(const RecordStore &store, ostream &out, PersonKind kind)
+{
+    out << "id,type,name,age,phone,address,subject,designation\n";
+    long long rows = 0;
+    for (Person *person : store)
+    {
+        PersonKind person_kind = person->getKind();
+        if (kind != KIND_COUNT && person_kind != kind)
+        {
+            continue;
+        }
+        out << person->getId() << ',' << Person::kind_name(person_kind) << ',';
+        write_csv_field(out, person->getName());
+        out << ',' << person->getAge() << ',';
+        write_csv_field(out, person->getPhone());
+        out << ',';
+        write_csv_field(out, person->getAddress());
+        out << ',';
+        if (person_kind == KIND_TEACHER)
+            write_csv_field(out, static_cast<Teacher *>(person)->getSubject());
+        out << ',';
+        if (person_kind == KIND_STAFF)
+            write_csv_field(out, static_cast<Staff *>(person)->getDesignation());
+        out << '\n';
+        rows++;
+    }
+    return rows;
+}
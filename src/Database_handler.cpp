@@ -3,9 +3,18 @@
 #include "Student.h"
 #include "Teacher.h"
 #include "Staff.h"
+#include "RecordStore.h"
+#include "IdAllocator.h"
+#include "RecordParser.h"
+#include "Metrics.h"
+#include "ThreadPool.h"
+#include "ObjectPool.h"
+#include "StringTable.h"
 
 #include <iostream>
 #include <fstream>
+#include <vector>
+#include <stdexcept>
 #include <sys/stat.h>
 
 #ifdef _WIN32
@@ -27,8 +36,9 @@ void ensureDataDirectory()
     }
 }
 
-void save_person(Person **data)
+void save_person(const RecordStore &store)
 {
+    ScopedTimer timer(TIMER_SAVE);
     ensureDataDirectory();
 
     ofstream file_stud("../data/students.txt");
@@ -40,221 +50,181 @@ void save_person(Person **data)
         cerr << "Error opening file for writing." << endl;
         return;
     }
-    for (int i = 0; i < 100; i++)
+    // Fields are streamed straight from the records: no copies, and no
+    // flush per line
+    for (Person *person : store)
     {
-        if (data[i] != nullptr)
+        switch (person->getKind())
         {
-            if (data[i]->printType() == "Student")
-            {
-                file_stud << data[i]->getName() << "`"
-                          << data[i]->getAge() << "`"
-                          << data[i]->getPhone() << "`"
-                          << data[i]->getAddress() << "`"
-                          << data[i]->getId() << endl;
-            }
-            else if (data[i]->printType() == "Teacher")
-            {
-                Teacher *teacher = static_cast<Teacher *>(data[i]);
-                file_teach << data[i]->getName() << "`"
-                           << data[i]->getAge() << "`"
-                           << data[i]->getPhone() << "`"
-                           << data[i]->getAddress() << "`"
-                           << data[i]->getId() << "`"
-                           << teacher->getSubject() << endl;
-            }
-            else if (data[i]->printType() == "Staff")
-            {
-                Staff *staff = static_cast<Staff *>(data[i]);
-                file_staff << data[i]->getName() << "`"
-                           << data[i]->getAge() << "`"
-                           << data[i]->getPhone() << "`"
-                           << data[i]->getAddress() << "`"
-                           << data[i]->getId() << "`"
-                           << staff->getDesignation() << endl;
-            }
+        case KIND_STUDENT:
+            file_stud << person->getName() << "`"
+                      << person->getAge() << "`"
+                      << person->getPhone() << "`"
+                      << person->getAddress() << "`"
+                      << person->getId() << '\n';
+            break;
+        case KIND_TEACHER:
+            file_teach << person->getName() << "`"
+                       << person->getAge() << "`"
+                       << person->getPhone() << "`"
+                       << person->getAddress() << "`"
+                       << person->getId() << "`"
+                       << static_cast<Teacher *>(person)->getSubject() << '\n';
+            break;
+        case KIND_STAFF:
+            file_staff << person->getName() << "`"
+                       << person->getAge() << "`"
+                       << person->getPhone() << "`"
+                       << person->getAddress() << "`"
+                       << person->getId() << "`"
+                       << static_cast<Staff *>(person)->getDesignation() << '\n';
+            break;
+        default:
+            break;
         }
     }
     file_stud.close();
     file_teach.close();
     file_staff.close();
+    Metrics::count(COUNTER_RECORDS_SAVED, store.size());
 }
 
-Person **read_person(int *ids, int &current_id)
+// Read a whole file into memory with a single read
+static bool read_file(const char *path, string &buffer)
 {
-    Person **data = new Person *[100];
-    for (int i = 0; i < 100; i++)
+    ifstream file(path, ios::binary);
+    if (!file.is_open())
     {
-        data[i] = nullptr;
+        return false;
     }
-
-    for (int i = 0; i < 100; i++)
+    file.seekg(0, ios::end);
+    streamoff size = file.tellg();
+    file.seekg(0, ios::beg);
+    buffer.resize(size > 0 ? (size_t)size : 0);
+    if (size > 0)
     {
-        ids[i] = 0;
-    }
-
-    ifstream file_stud("../data/students.txt");
-    ifstream file_teach("../data/teachers.txt");
-    ifstream file_staff("../data/staff.txt");
-
-    if (!file_stud.is_open() || !file_teach.is_open() || !file_staff.is_open())
-    {
-        cout << "Data files not found. Starting with empty database." << endl;
-        return data;
+        file.read(&buffer[0], size);
     }
+    return true;
+}
 
-    string line;
-    int index = 0;
+// Files are cut into chunks of about this size for parallel parsing
+const size_t LOAD_CHUNK_SIZE = 1 << 20;
 
-    // Read students
-    while (getline(file_stud, line) && !line.empty())
+struct LoadChunk
+{
+    const RecordLayout *layout;
+    string_view text;
+    vector<Person *> records;
+    vector<string> errors;
+    string failure;             // Set when the string table ran out of room
+};
+
+// Split a buffer into chunks that end on line boundaries
+static void add_chunks(vector<LoadChunk> &chunks, const RecordLayout &layout, string_view buffer)
+{
+    size_t start = 0;
+    while (start < buffer.size())
     {
-        string name, age_str, phone, address, id_str;
-        size_t pos1 = line.find('`');
-        size_t pos2 = line.find('`', pos1 + 1);
-        size_t pos3 = line.find('`', pos2 + 1);
-        size_t pos4 = line.find('`', pos3 + 1);
-
-        if (pos1 == string::npos || pos2 == string::npos || pos3 == string::npos || pos4 == string::npos)
+        size_t end = start + LOAD_CHUNK_SIZE;
+        if (end >= buffer.size())
         {
-            continue;
+            end = buffer.size();
         }
-
-        name = line.substr(0, pos1);
-        age_str = line.substr(pos1 + 1, pos2 - pos1 - 1);
-        phone = line.substr(pos2 + 1, pos3 - pos2 - 1);
-        address = line.substr(pos3 + 1, pos4 - pos3 - 1);
-        id_str = line.substr(pos4 + 1);
-
-        try
+        else
         {
-            int age = stoi(age_str);
-            int id = stoi(id_str);
-
-            Student *student = new Student();
-            student->setName(name);
-            student->setAge(age);
-            student->setPhone(phone);
-            student->setAddress(address);
-            student->setId(id);
-            ids[index] = id;
-            // Keep track of maximum ID for proper ID generation
-            if (id > current_id) {
-                current_id = id;
-            }
-
-            data[index++] = student;
-        }
-        catch (const exception &e)
-        {
-            cerr << "Error parsing student data: " << line << endl;
-            continue;
+            end = buffer.find('\n', end);
+            end = (end == string_view::npos) ? buffer.size() : end + 1;
         }
+        LoadChunk chunk;
+        chunk.layout = &layout;
+        chunk.text = buffer.substr(start, end - start);
+        chunks.push_back(chunk);
+        start = end;
     }
+}
 
-    // Read teachers
-    while (getline(file_teach, line) && !line.empty())
+void read_person(RecordStore &store, IdAllocator &ids)
+{
+    string buffers[3];
+    for (int i = 0; i < 3; i++)
     {
-        string name, age_str, phone, address, id_str, subject;
-        size_t pos1 = line.find('`');
-        size_t pos2 = line.find('`', pos1 + 1);
-        size_t pos3 = line.find('`', pos2 + 1);
-        size_t pos4 = line.find('`', pos3 + 1);
-        size_t pos5 = line.find('`', pos4 + 1);
-
-        if (pos1 == string::npos || pos2 == string::npos || pos3 == string::npos ||
-            pos4 == string::npos || pos5 == string::npos)
+        if (!read_file(RECORD_LAYOUTS[i].path, buffers[i]))
         {
-            continue; // Skip malformed lines
+            cout << "Data files not found. Starting with empty database." << endl;
+            return;
         }
+    }
 
-        name = line.substr(0, pos1);
-        age_str = line.substr(pos1 + 1, pos2 - pos1 - 1);
-        phone = line.substr(pos2 + 1, pos3 - pos2 - 1);
-        address = line.substr(pos3 + 1, pos4 - pos3 - 1);
-        id_str = line.substr(pos4 + 1, pos5 - pos4 - 1);
-        subject = line.substr(pos5 + 1);
+    vector<LoadChunk> chunks;
+    for (int i = 0; i < 3; i++)
+    {
+        add_chunks(chunks, RECORD_LAYOUTS[i], buffers[i]);
+    }
 
-        try
+    // Parse every chunk independently, each one fills only its own lists.
+    // Records come from a thread-local pool run, and the chunk's addresses,
+    // subjects and designations are interned in one batch, so the shared
+    // locks are taken once per run and once per chunk, not per record.
+    ThreadPool pool;
+    pool.run((int)chunks.size(), [&](int index)
+             {
+                 LoadChunk &chunk = chunks[index];
+                 ObjectPool::LocalCache cache;
+                 vector<string_view> values;
+                 parse_records(
+                     chunk.text, *chunk.layout,
+                     [&](Person *person) { chunk.records.push_back(person); },
+                     [&](string_view line) { chunk.errors.push_back(string(line)); }, &values);
+                 vector<StringHandle> handles(values.size());
+                 try
+                 {
+                     StringTable::shared().intern(values.data(), values.size(), handles.data());
+                     assign_interned(chunk.records, *chunk.layout, handles.data());
+                 }
+                 catch (const length_error &e)
+                 {
+                     chunk.failure = e.what();
+                 }
+             });
+
+    // A chunk that did not fit fails the whole load, a partial roster
+    // would be saved over the complete one on the next compaction
+    for (const LoadChunk &chunk : chunks)
+    {
+        if (!chunk.failure.empty())
         {
-            int age = stoi(age_str);
-            int id = stoi(id_str);
-
-            Teacher *teacher = new Teacher();
-            teacher->setName(name);
-            teacher->setAge(age);
-            teacher->setPhone(phone);
-            teacher->setAddress(address);
-            teacher->setId(id);
-            teacher->setSubject(subject);
-
-            ids[index] = id;
-            // Keep track of maximum ID for proper ID generation
-            if (id > current_id) {
-                current_id = id;
+            for (LoadChunk &drop : chunks)
+            {
+                for (Person *person : drop.records)
+                {
+                    delete person;
+                }
             }
-            data[index++] = teacher;
-        }
-        catch (const exception &e)
-        {
-            cerr << "Error parsing teacher data: " << line << endl;
-            continue;
+            throw length_error(chunk.failure);
         }
     }
 
-    // Read staff
-    while (getline(file_staff, line) && !line.empty())
+    // Merge in file and chunk order, so the result matches a sequential load
+    size_t total = 0;
+    for (const LoadChunk &chunk : chunks)
     {
-        string name, age_str, phone, address, id_str, designation;
-        size_t pos1 = line.find('`');
-        size_t pos2 = line.find('`', pos1 + 1);
-        size_t pos3 = line.find('`', pos2 + 1);
-        size_t pos4 = line.find('`', pos3 + 1);
-        size_t pos5 = line.find('`', pos4 + 1);
-
-        if (pos1 == string::npos || pos2 == string::npos || pos3 == string::npos ||
-            pos4 == string::npos || pos5 == string::npos)
+        total += chunk.records.size();
+    }
+    store.reserve(store.size() + (int)total);
+    store.begin_bulk_load();
+    for (const LoadChunk &chunk : chunks)
+    {
+        for (const string &line : chunk.errors)
         {
-            continue; // Skip malformed lines
+            cerr << "Error parsing " << chunk.layout->label << " data: " << line << endl;
         }
-
-        name = line.substr(0, pos1);
-        age_str = line.substr(pos1 + 1, pos2 - pos1 - 1);
-        phone = line.substr(pos2 + 1, pos3 - pos2 - 1);
-        address = line.substr(pos3 + 1, pos4 - pos3 - 1);
-        id_str = line.substr(pos4 + 1, pos5 - pos4 - 1);
-        designation = line.substr(pos5 + 1);
-
-        try
+        for (Person *person : chunk.records)
         {
-            int age = stoi(age_str);
-            int id = stoi(id_str);
-
-            Staff *staff = new Staff();
-            staff->setName(name);
-            staff->setAge(age);
-            staff->setPhone(phone);
-            staff->setAddress(address);
-            staff->setId(id);
-            staff->setDesignation(designation);
-
-            ids[index] = id;
             // Keep track of maximum ID for proper ID generation
-            if (id > current_id) {
-                current_id = id;
-            }
-            data[index++] = staff;
-        }
-        catch (const exception &e)
-        {
-            cerr << "Error parsing staff data: " << line << endl;
-            continue;
+            ids.seed(person->getId());
+            store.insert(person);
         }
     }
-
-    file_stud.close();
-    file_teach.close();
-    file_staff.close();
-    data[index] = nullptr;
-
-    return data;
+    store.end_bulk_load();
 }
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include "FrameBuffer.h"
+
+#include <iostream>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <io.h>
+#define write_stdout(data, size) _write(1, data, (unsigned int)(size))
+#else
+#include <unistd.h>
+#define write_stdout(data, size) ::write(STDOUT_FILENO, data, size)
+#endif
+
+using namespace std;
+
+int FrameBuffer::writes = 0;
+
+FrameBuffer::FrameBuffer() : depth(0) {}
+
+ostream &FrameBuffer::out() { return stream; }
+
+void FrameBuffer::begin() { depth++; }
+
+void FrameBuffer::end()
+{
+    if (depth > 0 && --depth == 0)
+    {
+        flush();
+    }
+}
+
+void FrameBuffer::flush()
+{
+    string text = stream.str();
+    if (text.empty())
+    {
+        return;
+    }
+    stream.str("");
+    write_all(text);
+}
+
+bool FrameBuffer::active() const { return depth > 0; }
+
+void FrameBuffer::write_all(const string &text)
+{
+    // Anything already sent through cout/stdio must appear first
+    cout.flush();
+    fflush(stdout);
+
+    writes++;
+    size_t written = 0;
+    while (written < text.size())
+    {
+        long result = (long)write_stdout(text.data() + written, text.size() - written);
+        if (result <= 0)
+        {
+            return;
+        }
+        written += (size_t)result;
+    }
+}
+
+int FrameBuffer::getWriteCount() { return writes; }
@@ -0,0 +1,69 @@
+#include "IdAllocator.h"
+
+using namespace std;
+
+IdAllocator::IdAllocator() : high_water(FIRST_ID) {}
+
+void IdAllocator::seed(int id)
+{
+    if (id > high_water)
+    {
+        high_water = id;
+    }
+    // An ID seen in use again (journal replay) is no longer free;
+    // its stale entry in free_ids is skipped by allocate()
+    free_set.erase(id);
+}
+
+int IdAllocator::allocate()
+{
+    while (!free_ids.empty())
+    {
+        int id = free_ids.back();
+        free_ids.pop_back();
+        if (free_set.erase(id))
+        {
+            return id;
+        }
+    }
+    return ++high_water;
+}
+
+void IdAllocator::release(int id)
+{
+    // Only IDs this allocator could have handed out can come back
+    if (id <= FIRST_ID || id > high_water)
+    {
+        return;
+    }
+    if (free_set.insert(id).second)
+    {
+        free_ids.push_back(id);
+    }
+}
+
+int IdAllocator::getHighWater() const { return high_water; }
+int IdAllocator::free_count() const { return (int)free_set.size(); }
+
+vector<int> IdAllocator::free_list() const
+{
+    // free_ids may still hold stale or repeated entries, allocate() skips
+    // them, so keep the topmost live copy of each id
+    vector<int> list;
+    unordered_set<int> seen;
+    for (vector<int>::const_reverse_iterator it = free_ids.rbegin(); it != free_ids.rend(); ++it)
+    {
+        if (free_set.count(*it) != 0 && seen.insert(*it).second)
+        {
+            list.push_back(*it);
+        }
+    }
+    return vector<int>(list.rbegin(), list.rend());
+}
+
+void IdAllocator::reset()
+{
+    high_water = FIRST_ID;
+    free_ids.clear();
+    free_set.clear();
+}
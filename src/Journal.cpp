@@ -0,0 +1,302 @@
+#include "Journal.h"
+#include "Metrics.h"
+#include "Database_handler.h"
+#include "Student.h"
+#include "Teacher.h"
+#include "Staff.h"
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <cstdio>
+#include <utility>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <io.h>
+#define open_append(path) _open(path, _O_WRONLY | _O_APPEND | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE)
+#define write_fd _write
+#define close_fd _close
+#define sync_fd _commit
+#else
+#include <unistd.h>
+#define open_append(path) ::open(path, O_WRONLY | O_APPEND | O_CREAT, 0644)
+#define write_fd ::write
+#define close_fd ::close
+#define sync_fd ::fsync
+#endif
+
+using namespace std;
+
+static unsigned int checksum(const string &text)
+{
+    unsigned int hash = 2166136261u;
+    for (unsigned char ch : text)
+    {
+        hash ^= ch;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static vector<string> split_fields(const string &line)
+{
+    vector<string> fields;
+    size_t start = 0;
+    size_t pos;
+    while ((pos = line.find('`', start)) != string::npos)
+    {
+        fields.push_back(line.substr(start, pos - start));
+        start = pos + 1;
+    }
+    fields.push_back(line.substr(start));
+    return fields;
+}
+
+Journal::Journal(const string &path)
+    : path(path), fd(-1), entries(0), sync_every(1), unsynced(0), appended(0), durable(0) {}
+
+bool Journal::open()
+{
+    if (fd >= 0)
+    {
+        return true;
+    }
+    ensureDataDirectory();
+    fd = open_append(path.c_str());
+    if (fd < 0)
+    {
+        cerr << "Error opening journal for writing." << endl;
+        return false;
+    }
+    return true;
+}
+
+void Journal::close()
+{
+    if (fd >= 0)
+    {
+        sync();
+        close_fd(fd);
+        fd = -1;
+    }
+}
+
+bool Journal::append(const string &line)
+{
+    if (fd < 0 && !open())
+    {
+        return false;
+    }
+    string entry = line + "`" + to_string(checksum(line)) + "\n";
+    size_t written = 0;
+    while (written < entry.size())
+    {
+        int result = write_fd(fd, entry.data() + written, (unsigned int)(entry.size() - written));
+        if (result <= 0)
+        {
+            cerr << "Error writing journal entry." << endl;
+            return false;
+        }
+        written += result;
+    }
+    entries++;
+    unsynced++;
+    appended++;
+    if (unsynced >= sync_every)
+    {
+        return sync();
+    }
+    return true;
+}
+
+string Journal::record_line(char op, Person *person)
+{
+    static const string none;
+    const string *extra = &none;
+    if (person->getKind() == KIND_TEACHER)
+    {
+        extra = &static_cast<Teacher *>(person)->getSubject();
+    }
+    else if (person->getKind() == KIND_STAFF)
+    {
+        extra = &static_cast<Staff *>(person)->getDesignation();
+    }
+    return string(1, op) + "`" + Person::kind_name(person->getKind()) + "`" + to_string(person->getId()) + "`" +
+           to_string(person->getAge()) + "`" + person->getName() + "`" + person->getPhone() + "`" +
+           person->getAddress() + "`" + *extra;
+}
+
+bool Journal::log_add(Person *person) { return append(record_line('A', person)); }
+bool Journal::log_modify(Person *person) { return append(record_line('M', person)); }
+bool Journal::log_delete(int id) { return append("D`" + to_string(id)); }
+
+bool Journal::sync()
+{
+    if (fd < 0 || unsynced == 0)
+    {
+        return true;
+    }
+    unsynced = 0;
+    long long target = appended;
+    Metrics::count(COUNTER_JOURNAL_SYNCS);
+    if (sync_fd(fd) != 0)
+    {
+        return false;
+    }
+    durable = target;
+    return true;
+}
+
+bool Journal::sync_through(long long position)
+{
+    if (durable >= position || fd < 0)
+    {
+        return true;
+    }
+    // Everything appended before the fsync starts is covered by it
+    long long target = appended;
+    Metrics::count(COUNTER_JOURNAL_SYNCS);
+    if (sync_fd(fd) != 0)
+    {
+        return false;
+    }
+    durable = target;
+    return true;
+}
+
+bool Journal::replay(RecordStore &store, IdAllocator &ids, int *applied_count)
+{
+    ifstream file(path.c_str());
+    if (!file.is_open())
+    {
+        if (applied_count != nullptr)
+            *applied_count = 0;
+        return true;
+    }
+
+    string line;
+    int applied = 0;
+    int rejected = 0;
+    long long line_number = 0;
+    while (getline(file, line))
+    {
+        line_number++;
+        size_t last = line.rfind('`');
+        if (line.empty())
+        {
+            continue;
+        }
+        string body = last == string::npos ? string() : line.substr(0, last);
+        if (last == string::npos || line.substr(last + 1) != to_string(checksum(body)))
+        {
+            // Torn or corrupted entry, normally the last write before a crash
+            cerr << "Skipping damaged journal entry." << endl;
+            continue;
+        }
+
+        // The checksum matches, so this was a committed operation: anything
+        // that stops it from being applied is an error, not a torn write
+        vector<string> fields = split_fields(body);
+        string problem;
+        try
+        {
+            if (fields[0] == "D" && fields.size() == 2)
+            {
+                int id = stoi(fields[1]);
+                store.erase(store.find(id));
+                ids.release(id);
+            }
+            else if ((fields[0] == "A" || fields[0] == "M") && fields.size() == 8)
+            {
+                int id = stoi(fields[2]);
+                int age = stoi(fields[3]);
+                Person *person = Person::create(fields[1]);
+                if (person == nullptr)
+                {
+                    problem = "unknown type '" + fields[1] + "'";
+                }
+                else
+                {
+                    try
+                    {
+                        // Base class setters ignore the field for the other types
+                        person->setSubject(fields[7]);
+                        person->setDesignation(move(fields[7]));
+                        person->setAddress(move(fields[6]));
+                    }
+                    catch (const length_error &)
+                    {
+                        delete person;
+                        throw;
+                    }
+                    person->setId(id);
+                    person->setAge(age);
+                    person->setName(move(fields[4]));
+                    person->setPhone(move(fields[5]));
+
+                    int index = store.find(person->getId());
+                    person->save(store, index);
+                    ids.seed(person->getId());
+                }
+            }
+            else if (fields[0] == "A" || fields[0] == "M" || fields[0] == "D")
+            {
+                problem = to_string(fields.size()) + " fields";
+            }
+            else
+            {
+                problem = "unknown operation '" + fields[0] + "'";
+            }
+        }
+        catch (const length_error &e)
+        {
+            problem = e.what();
+        }
+        catch (const exception &e)
+        {
+            problem = "bad number";
+        }
+        if (!problem.empty())
+        {
+            cerr << "Error: journal entry on line " << line_number << " was committed but cannot be applied ("
+                 << problem << "): " << line << endl;
+            rejected++;
+            continue;
+        }
+        applied++;
+    }
+    entries = applied;
+    if (applied_count != nullptr)
+        *applied_count = applied;
+    return rejected == 0;
+}
+
+bool Journal::reset()
+{
+    bool was_open = fd >= 0;
+    if (was_open)
+    {
+        close_fd(fd);
+        fd = -1;
+    }
+    ofstream truncate_file(path.c_str(), ios::trunc);
+    truncate_file.close();
+    entries = 0;
+    unsynced = 0;
+    // Everything logged so far is part of the base files now
+    durable = appended.load();
+    return !was_open || open();
+}
+
+void Journal::setSyncEvery(int count) { sync_every = count < 1 ? 1 : count; }
+int Journal::getEntries() const { return entries; }
+long long Journal::getAppended() const { return appended; }
+bool Journal::needs_compaction() const { return entries >= COMPACT_THRESHOLD; }
+
+Journal::~Journal()
+{
+    close();
+}
@@ -0,0 +1,131 @@
+#include "MemoryAccounting.h"
+#include "RecordStore.h"
+#include "Student.h"
+#include "Teacher.h"
+#include "Staff.h"
+#include "StringTable.h"
+
+#include <cstdio>
+
+#ifdef _WIN32
+#define PSAPI_VERSION 2     // GetProcessMemoryInfo from kernel32, no psapi.lib
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+MemoryAccounting::Counter MemoryAccounting::counters[MEM_COUNT];
+
+static const char *const SUBSYSTEM_NAMES[MEM_COUNT] = {"records", "store", "indexes", "versions"};
+
+size_t MemoryAccounting::in_use(MemorySubsystem subsystem)
+{
+    int64_t bytes = counters[subsystem].bytes.load(memory_order_relaxed);
+    return bytes > 0 ? (size_t)bytes : 0;
+}
+
+size_t MemoryAccounting::allocation_count(MemorySubsystem subsystem)
+{
+    int64_t blocks = counters[subsystem].blocks.load(memory_order_relaxed);
+    return blocks > 0 ? (size_t)blocks : 0;
+}
+
+const char *MemoryAccounting::subsystem_name(MemorySubsystem subsystem)
+{
+    return subsystem < MEM_COUNT ? SUBSYSTEM_NAMES[subsystem] : "unknown";
+}
+
+size_t MemoryAccounting::process_rss()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS info;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &info, sizeof(info)))
+    {
+        return info.WorkingSetSize;
+    }
+    return 0;
+#elif defined(__APPLE__)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) == KERN_SUCCESS)
+    {
+        return info.resident_size;
+    }
+    return 0;
+#else
+    // Second field of statm: resident pages
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (statm == nullptr)
+    {
+        return 0;
+    }
+    unsigned long total_pages = 0, resident_pages = 0;
+    int read = fscanf(statm, "%lu %lu", &total_pages, &resident_pages);
+    fclose(statm);
+    return read == 2 ? resident_pages * (size_t)sysconf(_SC_PAGESIZE) : 0;
+#endif
+}
+
+MemoryReport MemoryAccounting::measure(const RecordStore &store)
+{
+    MemoryReport report = MemoryReport();
+    for (Person *person : store)
+    {
+        switch (person->getKind())
+        {
+        case KIND_STUDENT:
+            report.record_bytes += sizeof(Student);
+            break;
+        case KIND_TEACHER:
+            report.record_bytes += sizeof(Teacher);
+            break;
+        default:
+            report.record_bytes += sizeof(Staff);
+            break;
+        }
+        // Address, subject and designation are handles, their text is in the StringTable
+        report.string_bytes += heap_bytes(person->getName()) + heap_bytes(person->getPhone());
+    }
+    report.interned_bytes = StringTable::shared().bytes();
+    for (int i = 0; i < MEM_COUNT; i++)
+    {
+        report.tracked[i] = in_use((MemorySubsystem)i);
+        report.allocations[i] = allocation_count((MemorySubsystem)i);
+    }
+    report.rss_bytes = process_rss();
+    return report;
+}
+
+size_t MemoryReport::accounted() const
+{
+    size_t total = string_bytes + interned_bytes;
+    for (int i = 0; i < MEM_COUNT; i++)
+    {
+        total += tracked[i];
+    }
+    return total;
+}
+
+string MemoryAccounting::format_bytes(size_t bytes)
+{
+    static const char *const UNITS[] = {"B", "KB", "MB", "GB", "TB"};
+    if (bytes < 1024)
+    {
+        return to_string(bytes) + " B";
+    }
+    double value = (double)bytes;
+    int unit = 0;
+    while (value >= 1024 && unit < 4)
+    {
+        value /= 1024;
+        unit++;
+    }
+    char text[32];
+    snprintf(text, sizeof(text), "%.1f %s", value, UNITS[unit]);
+    return text;
+}
@@ -0,0 +1,304 @@
+#include "Metrics.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <fstream>
+#include <cstring>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+static inline int __builtin_clzll(unsigned long long value)
+{
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return 63 - (int)index;
+}
+#endif
+
+using namespace std;
+
+static const char *const TIMER_NAMES[TIMER_COUNT] = {"load", "save", "lookup", "search", "add", "modify", "delete"};
+static const char *const COUNTER_NAMES[COUNTER_COUNT] = {"records_loaded", "records_saved", "lookup_misses",
+                                                         "journal_syncs", "rejected_changes"};
+
+namespace
+{
+// One thread's figures. Only the owning thread writes, so a relaxed load
+// and store replace a locked read-modify-write.
+struct Shard {
+    atomic<uint64_t> counts[TIMER_COUNT];
+    atomic<uint64_t> total_ns[TIMER_COUNT];
+    atomic<uint64_t> max_ns[TIMER_COUNT];
+    atomic<uint64_t> buckets[TIMER_COUNT][METRIC_BUCKETS];
+    atomic<uint64_t> counters[COUNTER_COUNT];
+
+    Shard()
+    {
+        for (int t = 0; t < TIMER_COUNT; t++)
+        {
+            counts[t].store(0, memory_order_relaxed);
+            total_ns[t].store(0, memory_order_relaxed);
+            max_ns[t].store(0, memory_order_relaxed);
+            for (int b = 0; b < METRIC_BUCKETS; b++)
+            {
+                buckets[t][b].store(0, memory_order_relaxed);
+            }
+        }
+        for (int c = 0; c < COUNTER_COUNT; c++)
+        {
+            counters[c].store(0, memory_order_relaxed);
+        }
+    }
+};
+
+inline void add(atomic<uint64_t> &value, uint64_t amount)
+{
+    value.store(value.load(memory_order_relaxed) + amount, memory_order_relaxed);
+}
+
+struct Registry {
+    mutex lock;
+    vector<Shard *> shards;       // Every shard ever handed out
+    vector<Shard *> idle;         // Shards whose thread has finished
+    MetricsSnapshot baseline;     // Subtracted by snapshot(), set by reset()
+
+    Registry() { memset(&baseline, 0, sizeof(baseline)); }
+};
+
+Registry &registry()
+{
+    // Never destroyed, threads may still record during static destruction
+    static Registry *instance = new Registry();
+    return *instance;
+}
+
+// Gives the thread's shard back when the thread ends
+struct ShardOwner {
+    Shard *shard = nullptr;
+
+    Shard &get()
+    {
+        if (shard == nullptr)
+        {
+            Registry &r = registry();
+            lock_guard<mutex> guard(r.lock);
+            if (!r.idle.empty())
+            {
+                shard = r.idle.back();
+                r.idle.pop_back();
+            }
+            else
+            {
+                shard = new Shard();
+                r.shards.push_back(shard);
+            }
+        }
+        return *shard;
+    }
+
+    ~ShardOwner()
+    {
+        if (shard != nullptr)
+        {
+            Registry &r = registry();
+            lock_guard<mutex> guard(r.lock);
+            r.idle.push_back(shard);
+        }
+    }
+};
+
+thread_local ShardOwner owner;
+
+int bucket_for(uint64_t nanos)
+{
+    if (nanos < 1024)
+    {
+        return 0;
+    }
+    int bits = 63 - __builtin_clzll(nanos);   // floor(log2), 10 or more here
+    return bits - 9 < METRIC_BUCKETS ? bits - 9 : METRIC_BUCKETS - 1;
+}
+
+// Upper bound of a bucket in nanoseconds, 0 for the open-ended last one
+uint64_t bucket_limit(int bucket)
+{
+    return bucket < METRIC_BUCKETS - 1 ? (uint64_t)1 << (bucket + 10) : 0;
+}
+
+MetricsSnapshot raw_snapshot(Registry &r)
+{
+    MetricsSnapshot total;
+    memset(&total, 0, sizeof(total));
+    for (Shard *shard : r.shards)
+    {
+        for (int t = 0; t < TIMER_COUNT; t++)
+        {
+            TimerStats &stats = total.timers[t];
+            stats.count += shard->counts[t].load(memory_order_relaxed);
+            stats.total_ns += shard->total_ns[t].load(memory_order_relaxed);
+            uint64_t longest = shard->max_ns[t].load(memory_order_relaxed);
+            stats.max_ns = longest > stats.max_ns ? longest : stats.max_ns;
+            for (int b = 0; b < METRIC_BUCKETS; b++)
+            {
+                stats.buckets[b] += shard->buckets[t][b].load(memory_order_relaxed);
+            }
+        }
+        for (int c = 0; c < COUNTER_COUNT; c++)
+        {
+            total.counters[c] += shard->counters[c].load(memory_order_relaxed);
+        }
+    }
+    return total;
+}
+} // namespace
+
+void Metrics::record(MetricTimer timer, uint64_t nanos)
+{
+    Shard &shard = owner.get();
+    add(shard.counts[timer], 1);
+    add(shard.total_ns[timer], nanos);
+    add(shard.buckets[timer][bucket_for(nanos)], 1);
+    if (nanos > shard.max_ns[timer].load(memory_order_relaxed))
+    {
+        shard.max_ns[timer].store(nanos, memory_order_relaxed);
+    }
+}
+
+void Metrics::count(MetricCounter counter, uint64_t amount)
+{
+    add(owner.get().counters[counter], amount);
+}
+
+MetricsSnapshot Metrics::snapshot()
+{
+    Registry &r = registry();
+    lock_guard<mutex> guard(r.lock);
+    MetricsSnapshot total = raw_snapshot(r);
+    for (int t = 0; t < TIMER_COUNT; t++)
+    {
+        TimerStats &stats = total.timers[t];
+        const TimerStats &base = r.baseline.timers[t];
+        stats.count -= base.count;
+        stats.total_ns -= base.total_ns;
+        // The maximum cannot be rewound, it restarts with the next sample
+        stats.max_ns = stats.count == 0 ? 0 : stats.max_ns;
+        for (int b = 0; b < METRIC_BUCKETS; b++)
+        {
+            stats.buckets[b] -= base.buckets[b];
+        }
+    }
+    for (int c = 0; c < COUNTER_COUNT; c++)
+    {
+        total.counters[c] -= r.baseline.counters[c];
+    }
+    return total;
+}
+
+void Metrics::reset()
+{
+    Registry &r = registry();
+    lock_guard<mutex> guard(r.lock);
+    r.baseline = raw_snapshot(r);
+}
+
+double TimerStats::mean_us() const
+{
+    return count == 0 ? 0 : total_ns / 1000.0 / count;
+}
+
+double TimerStats::percentile_us(double fraction) const
+{
+    if (count == 0)
+    {
+        return 0;
+    }
+    // Interpolate inside the bucket that holds the wanted rank
+    double rank = fraction * count;
+    uint64_t seen = 0;
+    for (int b = 0; b < METRIC_BUCKETS; b++)
+    {
+        if (buckets[b] == 0 || seen + buckets[b] < rank)
+        {
+            seen += buckets[b];
+            continue;
+        }
+        double low = b == 0 ? 0 : (double)((uint64_t)1 << (b + 9));
+        double high = bucket_limit(b) == 0 || bucket_limit(b) > max_ns ? (double)max_ns : (double)bucket_limit(b);
+        double estimate = low + (high - low) * ((rank - seen) / buckets[b]);
+        return (estimate < (double)max_ns ? estimate : (double)max_ns) / 1000.0;
+    }
+    return max_ns / 1000.0;
+}
+
+const char *Metrics::timer_name(MetricTimer timer)
+{
+    return timer < TIMER_COUNT ? TIMER_NAMES[timer] : "unknown";
+}
+
+const char *Metrics::counter_name(MetricCounter counter)
+{
+    return counter < COUNTER_COUNT ? COUNTER_NAMES[counter] : "unknown";
+}
+
+void Metrics::write_json(ostream &out)
+{
+    MetricsSnapshot metrics = snapshot();
+    out << "{\n  \"timers\": {\n";
+    for (int t = 0; t < TIMER_COUNT; t++)
+    {
+        const TimerStats &stats = metrics.timers[t];
+        out << "    \"" << TIMER_NAMES[t] << "\": {\"count\": " << stats.count
+            << ", \"total_seconds\": " << stats.total_ns / 1e9 << ", \"mean_us\": " << stats.mean_us()
+            << ", \"p50_us\": " << stats.percentile_us(0.5) << ", \"p99_us\": " << stats.percentile_us(0.99)
+            << ", \"max_us\": " << stats.max_ns / 1000.0 << "}" << (t + 1 < TIMER_COUNT ? "," : "") << "\n";
+    }
+    out << "  },\n  \"counters\": {\n";
+    for (int c = 0; c < COUNTER_COUNT; c++)
+    {
+        out << "    \"" << COUNTER_NAMES[c] << "\": " << metrics.counters[c] << (c + 1 < COUNTER_COUNT ? "," : "")
+            << "\n";
+    }
+    out << "  }\n}\n";
+}
+
+void Metrics::write_prometheus(ostream &out)
+{
+    MetricsSnapshot metrics = snapshot();
+    out << "# HELP sms_operation_duration_seconds Time taken by each operation.\n"
+        << "# TYPE sms_operation_duration_seconds histogram\n";
+    for (int t = 0; t < TIMER_COUNT; t++)
+    {
+        const TimerStats &stats = metrics.timers[t];
+        uint64_t cumulative = 0;
+        for (int b = 0; b < METRIC_BUCKETS - 1; b++)
+        {
+            cumulative += stats.buckets[b];
+            out << "sms_operation_duration_seconds_bucket{op=\"" << TIMER_NAMES[t] << "\",le=\""
+                << bucket_limit(b) / 1e9 << "\"} " << cumulative << "\n";
+        }
+        out << "sms_operation_duration_seconds_bucket{op=\"" << TIMER_NAMES[t] << "\",le=\"+Inf\"} " << stats.count
+            << "\n"
+            << "sms_operation_duration_seconds_sum{op=\"" << TIMER_NAMES[t] << "\"} " << stats.total_ns / 1e9 << "\n"
+            << "sms_operation_duration_seconds_count{op=\"" << TIMER_NAMES[t] << "\"} " << stats.count << "\n";
+    }
+    for (int c = 0; c < COUNTER_COUNT; c++)
+    {
+        out << "# TYPE sms_" << COUNTER_NAMES[c] << "_total counter\n"
+            << "sms_" << COUNTER_NAMES[c] << "_total " << metrics.counters[c] << "\n";
+    }
+}
+
+bool Metrics::write_file(const string &path)
+{
+    ofstream file(path);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    if (path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0)
+        write_json(file);
+    else
+        write_prometheus(file);
+    return file.good();
+}
@@ -0,0 +1,174 @@
+#include "ObjectPool.h"
+#include "MemoryAccounting.h"
+
+#include <new>
+
+using namespace std;
+
+namespace
+{
+// Blocks one thread reserved from one pool
+struct LocalRun {
+    ObjectPool *pool;
+    char *next;
+    char *end;
+};
+const int MAX_LOCAL_RUNS = 8;           // More pools than this fall back to locking
+thread_local LocalRun local_runs[MAX_LOCAL_RUNS];
+thread_local int local_depth = 0;       // Open LocalCache scopes on this thread
+} // namespace
+
+ObjectPool::ObjectPool(size_t block_size, size_t blocks_per_chunk)
+    : block_size(block_size), blocks_per_chunk(blocks_per_chunk < 1 ? 1 : blocks_per_chunk),
+      free_list(nullptr), next(nullptr), chunk_end(nullptr), live(0)
+{
+    // Every block must hold the free list link and stay aligned for any type
+    const size_t align = alignof(max_align_t);
+    if (this->block_size < sizeof(void *))
+    {
+        this->block_size = sizeof(void *);
+    }
+    this->block_size = (this->block_size + align - 1) / align * align;
+}
+
+// Caller holds the lock
+void ObjectPool::add_chunk()
+{
+    char *chunk = (char *)::operator new(block_size * blocks_per_chunk);
+    MemoryAccounting::allocated(MEM_RECORDS, block_size * blocks_per_chunk);
+    chunks.push_back(chunk);
+    next = chunk;
+    chunk_end = chunk + block_size * blocks_per_chunk;
+}
+
+void *ObjectPool::allocate()
+{
+    if (local_depth > 0)
+    {
+        void *block = allocate_local();
+        if (block != nullptr)
+        {
+            return block;
+        }
+    }
+    lock_guard<mutex> guard(lock);
+    live++;
+    if (free_list != nullptr)
+    {
+        void *block = free_list;
+        free_list = *(void **)block;
+        return block;
+    }
+    if (next == chunk_end)
+    {
+        add_chunk();
+    }
+    void *block = next;
+    next += block_size;
+    return block;
+}
+
+void *ObjectPool::allocate_local()
+{
+    LocalRun *run = nullptr;
+    for (int i = 0; i < MAX_LOCAL_RUNS && run == nullptr; i++)
+    {
+        if (local_runs[i].pool == this || local_runs[i].pool == nullptr)
+        {
+            run = &local_runs[i];
+            run->pool = this;
+        }
+    }
+    if (run == nullptr)
+    {
+        return nullptr;
+    }
+    if (run->next == run->end)
+    {
+        // One lock per run. The free list is left to the locked path, a
+        // bulk load into a fresh pool has nothing on it anyway.
+        lock_guard<mutex> guard(lock);
+        if (next == chunk_end)
+        {
+            add_chunk();
+        }
+        size_t available = (size_t)(chunk_end - next) / block_size;
+        size_t blocks = available < LOCAL_RUN_BLOCKS ? available : LOCAL_RUN_BLOCKS;
+        run->next = next;
+        run->end = next + blocks * block_size;
+        next = run->end;
+        live += blocks;
+    }
+    void *block = run->next;
+    run->next += block_size;
+    return block;
+}
+
+void ObjectPool::give_back(char *first, char *last)
+{
+    lock_guard<mutex> guard(lock);
+    for (char *block = first; block != last; block += block_size)
+    {
+        *(void **)block = free_list;
+        free_list = block;
+        live--;
+    }
+}
+
+ObjectPool::LocalCache::LocalCache() { local_depth++; }
+
+ObjectPool::LocalCache::~LocalCache()
+{
+    if (--local_depth > 0)
+    {
+        return;
+    }
+    for (int i = 0; i < MAX_LOCAL_RUNS && local_runs[i].pool != nullptr; i++)
+    {
+        local_runs[i].pool->give_back(local_runs[i].next, local_runs[i].end);
+        local_runs[i] = LocalRun();
+    }
+}
+
+void ObjectPool::deallocate(void *block)
+{
+    if (block == nullptr)
+    {
+        return;
+    }
+    lock_guard<mutex> guard(lock);
+    *(void **)block = free_list;
+    free_list = block;
+    live--;
+}
+
+void ObjectPool::release_all()
+{
+    lock_guard<mutex> guard(lock);
+    for (char *chunk : chunks)
+    {
+        MemoryAccounting::released(MEM_RECORDS, block_size * blocks_per_chunk);
+        ::operator delete(chunk);
+    }
+    chunks.clear();
+    free_list = nullptr;
+    next = chunk_end = nullptr;
+    live = 0;
+}
+
+size_t ObjectPool::live_count()
+{
+    lock_guard<mutex> guard(lock);
+    return live;
+}
+
+size_t ObjectPool::chunk_count()
+{
+    lock_guard<mutex> guard(lock);
+    return chunks.size();
+}
+
+ObjectPool::~ObjectPool()
+{
+    release_all();
+}
@@ -1,69 +1,117 @@
 #include "Person.h"
 #include "Utility.h"
+#include "RecordStore.h"
+#include "Student.h"
+#include "Teacher.h"
+#include "Staff.h"
 
 #include <iostream>
+#include <utility>
 using namespace std;
 
-int Person::count = 0;
+atomic<int> Person::count(0);
 
-Person::Person() : name(""), age(0), type("Person"), phone("0"), address(""), id(-1) { count++; }
+Person::Person(PersonKind kind) : id(-1), name(""), age(0), kind(kind), phone("0"), address(0) { count++; }
+Person::Person(const Person &other)
+    : id(other.id), name(other.name), age(other.age), kind(other.kind), phone(other.phone), address(other.address)
+{
+    count++;
+}
+
+static const string KIND_NAMES[KIND_COUNT + 1] = {"Student", "Teacher", "Staff", "Person"};
 
 // Getters
-string Person::getName() { return this->name; }
-int Person::getAge() { return this->age; }
-string Person::printType() { return this->type; }
-string Person::getPhone() { return this->phone; }
-string Person::getAddress() { return this->address; }
+const string &Person::getName() const { return this->name; }
+int Person::getAge() const { return this->age; }
+const string &Person::printType() const { return KIND_NAMES[kind < KIND_COUNT ? kind : KIND_COUNT]; }
+const string &Person::getPhone() const { return this->phone; }
+const string &Person::getAddress() const { return StringTable::shared().get(this->address); }
+StringHandle Person::getAddressHandle() const { return this->address; }
 int Person::getCount() { return count; }
-int Person::getId() { return this->id; }
+int Person::getId() const { return this->id; }
 
 // Setters
-void Person::setName(const string &name) { this->name = name; }
+void Person::setName(string name) { this->name = move(name); }
 void Person::setAge(int age) { this->age = age; }
-void Person::setType(const string &type) { this->type = type; }
-void Person::setPhone(const string &phone) { this->phone = phone; }
-void Person::setAddress(const string &address) { this->address = address; }
+void Person::setPhone(string phone) { this->phone = move(phone); }
+void Person::setAddress(string address) { this->address = StringTable::shared().intern(move(address)); }
+void Person::setAddressHandle(StringHandle address) { this->address = address; }
 void Person::setId(int id) { this->id = id; }
 
-bool Person::save(Person **data, int index)
+bool Person::save(RecordStore &store, int index)
 {
     if (index == -1)
     {
-        for (int i = 0; i < 100; i++)
-        {
-            if (data[i] == nullptr)
-            {
-                data[i] = this;
-                return true;
-            }
-        }
-        return false;
+        store.insert(this);
     }
     else
     {
-        data[index] = this;
-        return true;
+        store.replace(index, this);
     }
+    return true;
+}
+
+const char *Person::kind_name(PersonKind kind)
+{
+    return KIND_NAMES[kind < KIND_COUNT ? kind : KIND_COUNT].c_str();
 }
 
-int Person::get_person_by_id(int id, Person **data)
+bool Person::kind_from_name(const string &name, PersonKind &kind)
 {
-    for (int i = 0; i < 100; i++)
+    for (int i = 0; i < KIND_COUNT; i++)
     {
-        if (data[i] != nullptr && data[i]->getId() == id)
+        if (name == KIND_NAMES[i])
         {
-            cout << data[i]->printType() << endl;
-            data[i]->printDetails();
-            return i;
+            kind = (PersonKind)i;
+            return true;
         }
     }
-    return -1;
+    return false;
+}
+
+Person *Person::create(PersonKind kind)
+{
+    switch (kind)
+    {
+    case KIND_STUDENT:
+        return new Student();
+    case KIND_TEACHER:
+        return new Teacher();
+    case KIND_STAFF:
+        return new Staff();
+    default:
+        return nullptr;
+    }
+}
+
+Person *Person::create(const string &type)
+{
+    PersonKind kind;
+    return kind_from_name(type, kind) ? create(kind) : nullptr;
+}
+
+void Person::release_pools()
+{
+    Student::pool().release_all();
+    Teacher::pool().release_all();
+    Staff::pool().release_all();
+}
+
+int Person::get_person_by_id(int id, RecordStore &store)
+{
+    int index = store.find(id);
+    if (index != -1)
+    {
+        cout << store.at(index)->printType() << endl;
+        store.at(index)->printDetails();
+    }
+    return index;
 }
 
 void Person::get_common_inputs()
 {
     this->setName(Utility::take_string_input(this->printType()+" Name"));
-    this->setAge(Utility::take_integer_input(18, 50, this->printType()+" Age"));
+    this->setAge(Utility::take_integer_input(Utility::MIN_AGE, Utility::MAX_AGE, this->printType()+" Age"));
     this->setPhone(Utility::take_phone_input());
     this->setAddress(Utility::take_string_input(this->printType()+" Address"));
 }
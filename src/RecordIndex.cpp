@@ -0,0 +1,408 @@
+#include "RecordIndex.h"
+
+#include <algorithm>
+#include <cctype>
+#include <unordered_map>
+
+using namespace std;
+
+string RecordIndex::fold_case(const string &text)
+{
+    string folded(text);
+    for (char &ch : folded)
+    {
+        ch = (char)tolower((unsigned char)ch);
+    }
+    return folded;
+}
+
+// Trigrams of every word padded as "  word ", so word starts weigh more
+// than word ends and word order does not matter. Sorted, no duplicates.
+void RecordIndex::name_grams(string_view folded, vector<uint32_t> &out)
+{
+    out.clear();
+    uint32_t window = ((uint32_t)' ' << 8) | ' ';
+    bool in_word = false;
+    for (size_t i = 0; i <= folded.size(); i++)
+    {
+        unsigned char ch = i < folded.size() ? (unsigned char)folded[i] : ' ';
+        bool word_char = isalnum(ch) || ch >= 0x80;
+        if (!word_char)
+        {
+            if (in_word)
+            {
+                out.push_back(((window << 8) | ' ') & 0xFFFFFF);
+                window = ((uint32_t)' ' << 8) | ' ';
+                in_word = false;
+            }
+            continue;
+        }
+        window = ((window << 8) | ch) & 0xFFFFFF;
+        out.push_back(window);
+        in_word = true;
+    }
+    sort(out.begin(), out.end());
+    out.erase(unique(out.begin(), out.end()), out.end());
+}
+
+void RecordIndex::insert_sorted(Posting &posting, int value)
+{
+    // New slots and ids are usually the largest, only reused ones go in between
+    if (posting.empty() || posting.back() < value)
+    {
+        posting.push_back(value);
+    }
+    else
+    {
+        posting.insert(lower_bound(posting.begin(), posting.end(), value), value);
+    }
+}
+
+bool RecordIndex::erase_sorted(Posting &posting, int value)
+{
+    Posting::iterator found = lower_bound(posting.begin(), posting.end(), value);
+    if (found == posting.end() || *found != value)
+    {
+        return false;
+    }
+    posting.erase(found);
+    return true;
+}
+
+// Add a name group's trigrams to the postings
+void RecordIndex::index_grams(NameIndex::iterator entry, int id)
+{
+    vector<uint32_t> keys;
+    name_grams(entry->first, keys);
+    for (uint32_t key : keys)
+    {
+        insert_sorted(grams[key], id);
+    }
+    gram_counts[id] = (uint8_t)min(keys.size(), (size_t)255);
+}
+
+void RecordIndex::add(int slot, const Person *person, PersonKind kind, int age, StringHandle extra)
+{
+    if (slot >= (int)name_entries.size())
+    {
+        name_entries.resize(slot + 1, names.end());
+    }
+    string folded = fold_case(person->getName());
+    pair<NameIndex::iterator, bool> entry = names.emplace(Key(folded.data(), folded.size()), NameGroup());
+    NameGroup &group = entry.first->second;
+    if (entry.second)
+    {
+        // First record with this name, index its trigrams
+        if (free_groups.empty())
+        {
+            group.id = (int)groups.size();
+            groups.push_back(entry.first);
+            gram_counts.push_back(0);
+        }
+        else
+        {
+            group.id = free_groups.back();
+            free_groups.pop_back();
+            groups[group.id] = entry.first;
+        }
+        index_grams(entry.first, group.id);
+    }
+    insert_sorted(group.slots, slot);
+    name_entries[slot] = entry.first;
+
+    insert_sorted(ages[age], slot);
+    if (kind == KIND_TEACHER)
+    {
+        insert_sorted(subjects[extra], slot);
+    }
+    else if (kind == KIND_STAFF)
+    {
+        insert_sorted(designations[extra], slot);
+    }
+}
+
+void RecordIndex::erase_from(HandleIndex &index, StringHandle key, int slot)
+{
+    HandleIndex::iterator it = index.find(key);
+    if (it != index.end() && erase_sorted(it->second, slot) && it->second.empty())
+    {
+        index.erase(it);
+    }
+}
+
+void RecordIndex::remove(int slot, PersonKind kind, int age, StringHandle extra)
+{
+    if (slot >= (int)name_entries.size() || name_entries[slot] == names.end())
+    {
+        return;
+    }
+    // The group holds the indexed name, even if the record has changed since
+    NameIndex::iterator entry = name_entries[slot];
+    NameGroup &group = entry->second;
+    erase_sorted(group.slots, slot);
+    name_entries[slot] = names.end();
+    if (group.slots.empty())
+    {
+        vector<uint32_t> keys;
+        name_grams(entry->first, keys);
+        for (uint32_t key : keys)
+        {
+            GramIndex::iterator posting = grams.find(key);
+            if (posting == grams.end())
+            {
+                continue;
+            }
+            erase_sorted(posting->second, group.id);
+            if (posting->second.empty())
+            {
+                grams.erase(posting);
+            }
+        }
+        groups[group.id] = names.end();
+        free_groups.push_back(group.id);
+        names.erase(entry);
+    }
+
+    AgeIndex::iterator it = ages.find(age);
+    if (it != ages.end() && erase_sorted(it->second, slot) && it->second.empty())
+    {
+        ages.erase(it);
+    }
+    if (kind == KIND_TEACHER)
+    {
+        erase_from(subjects, extra, slot);
+    }
+    else if (kind == KIND_STAFF)
+    {
+        erase_from(designations, extra, slot);
+    }
+}
+
+void RecordIndex::clear()
+{
+    names.clear();
+    name_entries.clear();
+    groups.clear();
+    gram_counts.clear();
+    free_groups.clear();
+    grams.clear();
+    ages.clear();
+    subjects.clear();
+    designations.clear();
+}
+
+void RecordIndex::build(const Person *const *records, const uint8_t *kinds, const int *record_ages,
+                        const StringHandle *extras, int count)
+{
+    clear();
+    name_entries.resize(count, names.end());
+
+    // Group the slots by folded name. Slots are visited in order, so every
+    // list comes out ascending without sorting.
+    // Names repeat, so fold into one buffer and copy only the new ones
+    unordered_map<string, int> positions;
+    vector<pair<string, vector<int>>> found;
+    string folded;
+    for (int slot = 0; slot < count; slot++)
+    {
+        if (records[slot] == nullptr)
+        {
+            continue;
+        }
+        const string &name = records[slot]->getName();
+        folded.resize(name.size());
+        for (size_t i = 0; i < name.size(); i++)
+        {
+            folded[i] = (char)tolower((unsigned char)name[i]);
+        }
+        unordered_map<string, int>::iterator position = positions.find(folded);
+        if (position == positions.end())
+        {
+            position = positions.emplace(folded, (int)found.size()).first;
+            found.push_back(make_pair(folded, vector<int>()));
+        }
+        found[position->second].second.push_back(slot);
+
+        ages[record_ages[slot]].push_back(slot);
+        if (kinds[slot] == KIND_TEACHER)
+        {
+            subjects[extras[slot]].push_back(slot);
+        }
+        else if (kinds[slot] == KIND_STAFF)
+        {
+            designations[extras[slot]].push_back(slot);
+        }
+    }
+
+    // Distinct names sorted once, then appended to the map in order and
+    // numbered in name order, so every trigram posting is filled ascending
+    vector<int> order(found.size());
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        order[i] = (int)i;
+    }
+    sort(order.begin(), order.end(), [&](int a, int b) { return found[a].first < found[b].first; });
+    groups.reserve(order.size());
+    gram_counts.resize(order.size(), 0);
+    grams.reserve(order.size());
+    for (int index : order)
+    {
+        pair<string, vector<int>> &name = found[index];
+        NameIndex::iterator entry = names.emplace_hint(names.end(), Key(name.first.data(), name.first.size()),
+                                                       NameGroup());
+        NameGroup &group = entry->second;
+        group.id = (int)groups.size();
+        group.slots.assign(name.second.begin(), name.second.end());
+        groups.push_back(entry);
+        for (int slot : name.second)
+        {
+            name_entries[slot] = entry;
+        }
+        index_grams(entry, group.id);
+    }
+}
+
+vector<int> RecordIndex::name_prefix(const string &prefix, size_t limit) const
+{
+    vector<int> slots;
+    string key = fold_case(prefix);
+    for (NameIndex::const_iterator it = names.lower_bound(string_view(key)); it != names.end(); ++it)
+    {
+        if (string_view(it->first).compare(0, key.size(), key) != 0)
+        {
+            break;
+        }
+        for (int slot : it->second.slots)
+        {
+            if (limit != 0 && slots.size() >= limit)
+            {
+                return slots;
+            }
+            slots.push_back(slot);
+        }
+    }
+    return slots;
+}
+
+vector<int> RecordIndex::name_similar(const string &query, size_t limit) const
+{
+    vector<uint32_t> wanted;
+    name_grams(fold_case(query), wanted);
+    if (wanted.size() > 255)
+    {
+        wanted.resize(255);
+    }
+    if (wanted.empty() || limit == 0)
+    {
+        return vector<int>();
+    }
+
+    // Postings of the query trigrams, rarest first (missing = empty)
+    static const Posting none;
+    vector<const Posting *> postings;
+    for (uint32_t key : wanted)
+    {
+        GramIndex::const_iterator posting = grams.find(key);
+        postings.push_back(posting == grams.end() ? &none : &posting->second);
+    }
+    sort(postings.begin(), postings.end(),
+         [](const Posting *a, const Posting *b) { return a->size() < b->size(); });
+
+    // A name sharing `needed` of the query trigrams has at least one of
+    // the rarest size - needed + 1, so only those can add candidates.
+    // The common trigrams are then only checked against the candidates.
+    int needed = ((int)wanted.size() + 1) / 2;
+    size_t seeds = wanted.size() - needed + 1;
+    vector<uint8_t> shared(groups.size(), 0);
+    vector<int> touched;
+    for (size_t i = 0; i < postings.size(); i++)
+    {
+        const Posting &ids = *postings[i];
+        if (i < seeds)
+        {
+            for (int id : ids)
+            {
+                if (shared[id]++ == 0)
+                {
+                    touched.push_back(id);
+                }
+            }
+        }
+        else if (touched.size() * 16 < ids.size())
+        {
+            for (int id : touched)
+            {
+                if (binary_search(ids.begin(), ids.end(), id))
+                {
+                    shared[id]++;
+                }
+            }
+        }
+        else
+        {
+            for (int id : ids)
+            {
+                if (shared[id] != 0)
+                {
+                    shared[id]++;
+                }
+            }
+        }
+    }
+
+    vector<pair<float, int>> ranked;
+    for (int id : touched)
+    {
+        int common = shared[id];
+        if (common >= needed)
+        {
+            float score = (float)common / (float)(wanted.size() + gram_counts[id] - common);
+            ranked.push_back(make_pair(score, id));
+        }
+    }
+
+    // Best score first. Every name has at least one slot, so the best
+    // limit names are enough. Picking them compares numbers only, then
+    // the few that were picked are put in name order within a score.
+    size_t count = min(limit, ranked.size());
+    partial_sort(ranked.begin(), ranked.begin() + count, ranked.end(),
+                 [](const pair<float, int> &a, const pair<float, int> &b)
+                 { return a.first != b.first ? a.first > b.first : a.second < b.second; });
+    sort(ranked.begin(), ranked.begin() + count,
+         [this](const pair<float, int> &a, const pair<float, int> &b)
+         { return a.first != b.first ? a.first > b.first : groups[a.second]->first < groups[b.second]->first; });
+
+    vector<int> slots;
+    for (size_t i = 0; i < count && slots.size() < limit; i++)
+    {
+        const List<int> &group = groups[ranked[i].second]->second.slots;
+        size_t take = min(group.size(), limit - slots.size());
+        slots.insert(slots.end(), group.begin(), group.begin() + take);
+    }
+    return slots;
+}
+
+vector<int> RecordIndex::sorted_slots(const HandleIndex &index, StringHandle key)
+{
+    vector<int> slots;
+    HandleIndex::const_iterator it = index.find(key);
+    if (it != index.end())
+    {
+        slots.assign(it->second.begin(), it->second.end());
+    }
+    return slots;
+}
+
+vector<int> RecordIndex::subject(StringHandle subject) const { return sorted_slots(subjects, subject); }
+vector<int> RecordIndex::designation(StringHandle designation) const { return sorted_slots(designations, designation); }
+
+vector<int> RecordIndex::age_range(int min_age, int max_age) const
+{
+    vector<int> slots;
+    for (AgeIndex::const_iterator it = ages.lower_bound(min_age);
+         it != ages.end() && it->first <= max_age; ++it)
+    {
+        slots.insert(slots.end(), it->second.begin(), it->second.end());
+    }
+    return slots;
+}
@@ -0,0 +1,103 @@
+#include "RecordParser.h"
+#include "Student.h"
+#include "Teacher.h"
+#include "Staff.h"
+
+#include <charconv>
+#include <stdexcept>
+
+using namespace std;
+
+static Person *create_student() { return new Student(); }
+static Person *create_teacher() { return new Teacher(); }
+static Person *create_staff() { return new Staff(); }
+
+const RecordLayout RECORD_LAYOUTS[3] = {
+    {"student", "../data/students.txt", 5, create_student, nullptr, nullptr},
+    {"teacher", "../data/teachers.txt", 6, create_teacher, &Person::setSubject, &Person::setSubjectHandle},
+    {"staff", "../data/staff.txt", 6, create_staff, &Person::setDesignation, &Person::setDesignationHandle},
+};
+
+int split_record(string_view line, string_view *fields, int max_fields)
+{
+    int count = 0;
+    size_t start = 0;
+    while (count < max_fields - 1)
+    {
+        size_t pos = line.find('`', start);
+        if (pos == string_view::npos)
+        {
+            break;
+        }
+        fields[count++] = line.substr(start, pos - start);
+        start = pos + 1;
+    }
+    fields[count++] = line.substr(start);
+    return count;
+}
+
+bool parse_int(string_view text, int &value)
+{
+    const char *first = text.data();
+    const char *last = text.data() + text.size();
+    from_chars_result result = from_chars(first, last, value);
+    return result.ec == errc() && result.ptr == last && first != last;
+}
+
+Person *parse_record(string_view line, const RecordLayout &layout, vector<string_view> *deferred)
+{
+    string_view fields[RECORD_MAX_FIELDS];
+    if (split_record(line, fields, layout.field_count) != layout.field_count)
+    {
+        return nullptr;
+    }
+
+    int age, id;
+    if (!parse_int(fields[1], age) || !parse_int(fields[4], id))
+    {
+        return nullptr;
+    }
+
+    // Unique fields are copied once and moved into the record, repeating
+    // ones are interned straight from the buffer
+    Person *person = layout.create();
+    person->setName(string(fields[0]));
+    person->setAge(age);
+    person->setPhone(string(fields[2]));
+    person->setId(id);
+    if (deferred != nullptr)
+    {
+        deferred->push_back(fields[3]);
+        if (layout.set_extra_handle != nullptr)
+        {
+            deferred->push_back(fields[5]);
+        }
+        return person;
+    }
+    try
+    {
+        person->setAddressHandle(StringTable::shared().intern(fields[3]));
+        if (layout.set_extra != nullptr)
+        {
+            (person->*layout.set_extra)(string(fields[5]));
+        }
+    }
+    catch (const length_error &)
+    {
+        delete person;
+        throw;
+    }
+    return person;
+}
+
+void assign_interned(const vector<Person *> &records, const RecordLayout &layout, const StringHandle *handles)
+{
+    for (Person *person : records)
+    {
+        person->setAddressHandle(*handles++);
+        if (layout.set_extra_handle != nullptr)
+        {
+            (person->*layout.set_extra_handle)(*handles++);
+        }
+    }
+}
@@ -0,0 +1,410 @@
+#include "RecordStore.h"
+#include "Teacher.h"
+#include "Staff.h"
+#include "Metrics.h"
+
+#include <climits>
+#include <algorithm>
+
+using namespace std;
+
+RecordStore::RecordStore() : live(0), versions(nullptr), bulk_depth(0) {}
+
+void RecordStore::index_slot(int slot)
+{
+    // First record stored under an id wins, same as the old front-to-back scan
+    id_index.emplace(slots[slot]->getId(), slot);
+    if (bulk_depth > 0)
+    {
+        return;
+    }
+    search.add(slot, slots[slot], (PersonKind)kinds[slot], ages[slot], extras[slot]);
+}
+
+void RecordStore::unindex_slot(int slot)
+{
+    IdIndex::iterator it = id_index.find(slots[slot]->getId());
+    if (it != id_index.end() && it->second == slot)
+    {
+        id_index.erase(it);
+    }
+    // The columns still hold the values that were indexed
+    if (bulk_depth > 0)
+    {
+        return;
+    }
+    search.remove(slot, (PersonKind)kinds[slot], ages[slot], extras[slot]);
+}
+
+bool RecordStore::published(int slot) const
+{
+    // Readers find a record by id, so only the one the id index points at
+    if (versions == nullptr || slots[slot]->getId() < 0)
+    {
+        return false;
+    }
+    IdIndex::const_iterator it = id_index.find(slots[slot]->getId());
+    return it != id_index.end() && it->second == slot;
+}
+
+// A record leaving the store. Readers may still hold a published one,
+// the versions delete it once they cannot.
+void RecordStore::drop(Person *person, bool was_published, int replacement_id)
+{
+    if (!was_published)
+    {
+        delete person;
+    }
+    else if (person->getId() != replacement_id)
+    {
+        versions->publish(person->getId(), nullptr);
+    }
+    // Otherwise the replacement's publish already superseded it
+}
+
+void RecordStore::sync_row(int slot)
+{
+    Person *person = slots[slot];
+    if (person == nullptr)
+    {
+        kinds[slot] = FREE_ROW;
+        return;
+    }
+    ids[slot] = person->getId();
+    ages[slot] = person->getAge();
+    kinds[slot] = person->getKind();
+    addresses[slot] = person->getAddressHandle();
+    if (person->getKind() == KIND_TEACHER)
+        extras[slot] = static_cast<Teacher *>(person)->getSubjectHandle();
+    else if (person->getKind() == KIND_STAFF)
+        extras[slot] = static_cast<Staff *>(person)->getDesignationHandle();
+    else
+        extras[slot] = 0;
+}
+
+// Take a free slot off the free list in O(1): the last entry moves into
+// its place
+void RecordStore::take_free_slot(int slot)
+{
+    int position = free_positions[slot];
+    int last = free_slots.back();
+    free_slots[position] = last;
+    free_positions[last] = position;
+    free_slots.pop_back();
+    free_positions[slot] = -1;
+}
+
+int RecordStore::insert(Person *person)
+{
+    int slot;
+    if (!free_slots.empty())
+    {
+        slot = free_slots.back();
+        take_free_slot(slot);
+        slots[slot] = person;
+    }
+    else
+    {
+        slot = (int)slots.size();
+        slots.push_back(person);
+        ids.push_back(0);
+        ages.push_back(0);
+        kinds.push_back(FREE_ROW);
+        addresses.push_back(0);
+        extras.push_back(0);
+        free_positions.push_back(-1);
+    }
+    sync_row(slot);
+    index_slot(slot);
+    if (published(slot))
+    {
+        versions->publish(person->getId(), person);
+    }
+    live++;
+    return slot;
+}
+
+void RecordStore::replace(int slot, Person *person)
+{
+    if (slot < 0 || slot >= (int)slots.size())
+    {
+        return;
+    }
+    if (slots[slot] == person)
+    {
+        // Changed in place: re-index under the new values
+        unindex_slot(slot);
+        sync_row(slot);
+        index_slot(slot);
+        return;
+    }
+    if (slots[slot] == nullptr)
+    {
+        take_free_slot(slot);
+        live++;
+    }
+    Person *old = slots[slot];
+    bool was_published = old != nullptr && published(slot);
+    if (old != nullptr)
+    {
+        unindex_slot(slot);
+    }
+    slots[slot] = person;
+    sync_row(slot);
+    index_slot(slot);
+    if (published(slot))
+    {
+        versions->publish(person->getId(), person);
+    }
+    if (old != nullptr)
+    {
+        drop(old, was_published, person->getId());
+    }
+}
+
+bool RecordStore::erase(int slot)
+{
+    if (slot < 0 || slot >= (int)slots.size() || slots[slot] == nullptr)
+    {
+        return false;
+    }
+    bool was_published = published(slot);
+    unindex_slot(slot);
+    drop(slots[slot], was_published, -1);
+    slots[slot] = nullptr;
+    kinds[slot] = FREE_ROW;
+    free_positions[slot] = (int)free_slots.size();
+    free_slots.push_back(slot);
+    live--;
+    return true;
+}
+
+int RecordStore::find(int id) const
+{
+    IdIndex::const_iterator it = id_index.find(id);
+    if (it == id_index.end())
+    {
+        return -1;
+    }
+    return it->second;
+}
+
+Person *RecordStore::at(int slot) const
+{
+    if (slot < 0 || slot >= (int)slots.size())
+    {
+        return nullptr;
+    }
+    return slots[slot];
+}
+
+int RecordStore::size() const { return live; }
+int RecordStore::slot_count() const { return (int)slots.size(); }
+bool RecordStore::empty() const { return live == 0; }
+void RecordStore::reserve(int count)
+{
+    slots.reserve(count);
+    ids.reserve(count);
+    ages.reserve(count);
+    kinds.reserve(count);
+    addresses.reserve(count);
+    extras.reserve(count);
+    free_positions.reserve(count);
+    id_index.reserve(count);
+}
+
+void RecordStore::begin_bulk_load()
+{
+    if (bulk_depth++ == 0)
+    {
+        search.clear();
+    }
+}
+
+void RecordStore::end_bulk_load()
+{
+    if (bulk_depth > 0 && --bulk_depth == 0)
+    {
+        search.build(slots.data(), kinds.data(), ages.data(), extras.data(), (int)slots.size());
+    }
+}
+
+void RecordStore::publish_to(RecordVersions *target)
+{
+    if (versions != nullptr)
+    {
+        versions->clear();
+    }
+    versions = target;
+    for (int slot = 0; versions != nullptr && slot < (int)slots.size(); slot++)
+    {
+        if (slots[slot] != nullptr && published(slot))
+        {
+            versions->publish(slots[slot]->getId(), slots[slot]);
+        }
+    }
+}
+
+void RecordStore::clear()
+{
+    publish_to(nullptr);
+    for (size_t i = 0; i < slots.size(); i++)
+    {
+        delete slots[i];
+    }
+    slots.clear();
+    ids.clear();
+    ages.clear();
+    kinds.clear();
+    addresses.clear();
+    extras.clear();
+    free_slots.clear();
+    free_positions.clear();
+    id_index.clear();
+    search.clear();
+    live = 0;
+}
+
+void RecordStore::abandon()
+{
+    publish_to(nullptr);
+    slots.clear();
+    ids.clear();
+    ages.clear();
+    kinds.clear();
+    addresses.clear();
+    extras.clear();
+    free_slots.clear();
+    free_positions.clear();
+    id_index.clear();
+    search.clear();
+    live = 0;
+}
+
+vector<int> RecordStore::find_by_name_prefix(const string &prefix, size_t limit) const
+{
+    ScopedTimer timer(TIMER_SEARCH);
+    return search.name_prefix(prefix, limit);
+}
+
+vector<int> RecordStore::find_by_name(const string &query, size_t limit) const
+{
+    ScopedTimer timer(TIMER_SEARCH);
+    return search.name_similar(query, limit);
+}
+
+vector<int> RecordStore::find_by_subject(const string &subject) const
+{
+    ScopedTimer timer(TIMER_SEARCH);
+    StringHandle handle;
+    if (!StringTable::shared().find(subject, handle))
+    {
+        return vector<int>();
+    }
+    return search.subject(handle);
+}
+
+vector<int> RecordStore::find_by_designation(const string &designation) const
+{
+    ScopedTimer timer(TIMER_SEARCH);
+    StringHandle handle;
+    if (!StringTable::shared().find(designation, handle))
+    {
+        return vector<int>();
+    }
+    return search.designation(handle);
+}
+
+vector<int> RecordStore::find_by_age(int min_age, int max_age, PersonKind kind) const
+{
+    ScopedTimer timer(TIMER_SEARCH);
+    vector<int> slots = search.age_range(min_age, max_age);
+    if (kind != KIND_COUNT)
+    {
+        slots.erase(remove_if(slots.begin(), slots.end(), [&](int slot) { return kinds[slot] != kind; }), slots.end());
+    }
+    return slots;
+}
+
+const int *RecordStore::id_column() const { return ids.data(); }
+const int *RecordStore::age_column() const { return ages.data(); }
+const uint8_t *RecordStore::kind_column() const { return kinds.data(); }
+const StringHandle *RecordStore::address_column() const { return addresses.data(); }
+
+void RecordStore::count_by_kind(int counts[KIND_COUNT]) const
+{
+    int totals[FREE_ROW + 1] = {0};
+    for (uint8_t kind : kinds)
+    {
+        totals[kind]++;
+    }
+    for (int kind = 0; kind < KIND_COUNT; kind++)
+    {
+        counts[kind] = totals[kind];
+    }
+}
+
+AgeStats RecordStore::age_stats(PersonKind kind) const
+{
+    AgeStats stats = {0, INT_MAX, INT_MIN, 0.0};
+    long long sum = 0;
+    size_t rows = kinds.size();
+    const uint8_t *kind_data = kinds.data();
+    const int *age_data = ages.data();
+    for (size_t slot = 0; slot < rows; slot++)
+    {
+        bool match = kind == KIND_COUNT ? kind_data[slot] != FREE_ROW : kind_data[slot] == kind;
+        if (match)
+        {
+            int age = age_data[slot];
+            stats.count++;
+            sum += age;
+            stats.min_age = age < stats.min_age ? age : stats.min_age;
+            stats.max_age = age > stats.max_age ? age : stats.max_age;
+        }
+    }
+    if (stats.count == 0)
+    {
+        stats.min_age = stats.max_age = 0;
+    }
+    else
+    {
+        stats.average = (double)sum / stats.count;
+    }
+    return stats;
+}
+
+RecordStore::const_iterator::const_iterator(const RecordStore *store, int slot) : store(store), slot(slot)
+{
+    skip_free();
+}
+
+void RecordStore::const_iterator::skip_free()
+{
+    while (slot < (int)store->slots.size() && store->slots[slot] == nullptr)
+    {
+        slot++;
+    }
+}
+
+Person *RecordStore::const_iterator::operator*() const { return store->slots[slot]; }
+
+RecordStore::const_iterator &RecordStore::const_iterator::operator++()
+{
+    slot++;
+    skip_free();
+    return *this;
+}
+
+bool RecordStore::const_iterator::operator!=(const const_iterator &other) const
+{
+    return slot != other.slot;
+}
+
+RecordStore::const_iterator RecordStore::begin() const { return const_iterator(this, 0); }
+RecordStore::const_iterator RecordStore::end() const { return const_iterator(this, (int)slots.size()); }
+
+RecordStore::~RecordStore()
+{
+    clear();
+}
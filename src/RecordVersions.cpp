@@ -0,0 +1,187 @@
+#include "RecordVersions.h"
+
+#include <thread>
+#include <functional>
+
+using namespace std;
+
+RecordVersions::RecordVersions() : chunks(new atomic<Head *>[MAX_CHUNKS]), clock(0)
+{
+    MemoryAccounting::allocated(MEM_VERSIONS, MAX_CHUNKS * sizeof(atomic<Head *>));
+    for (uint32_t i = 0; i < MAX_CHUNKS; i++)
+    {
+        chunks[i].store(nullptr, memory_order_relaxed);
+    }
+    for (ReaderSlot &reader : readers)
+    {
+        reader.pinned.store(0, memory_order_relaxed);
+    }
+}
+
+RecordVersions::ReadView::ReadView(RecordVersions &versions) : versions(versions)
+{
+    // Start at a slot picked by thread so readers rarely compete for one
+    slot = (int)(hash<thread::id>()(this_thread::get_id()) % READER_SLOTS);
+    epoch = versions.clock.load();
+    for (int tried = 0;; tried++)
+    {
+        uint64_t expected = 0;
+        if (versions.readers[slot].pinned.compare_exchange_strong(expected, epoch + 1))
+        {
+            break;
+        }
+        slot = (slot + 1) % READER_SLOTS;
+        if (tried % READER_SLOTS == READER_SLOTS - 1)
+        {
+            this_thread::yield();
+        }
+    }
+    // A writer that moved the clock before seeing the pin may already have
+    // reclaimed versions of the old epoch, so pin the newer one instead
+    uint64_t now;
+    while ((now = versions.clock.load()) != epoch)
+    {
+        epoch = now;
+        versions.readers[slot].pinned.store(epoch + 1);
+    }
+}
+
+RecordVersions::ReadView::~ReadView()
+{
+    versions.readers[slot].pinned.store(0, memory_order_release);
+}
+
+const Person *RecordVersions::find(int id, uint64_t epoch) const
+{
+    if (id < 0)
+    {
+        return nullptr;
+    }
+    Head *chunk = chunks[id >> CHUNK_BITS].load(memory_order_acquire);
+    if (chunk == nullptr)
+    {
+        return nullptr;
+    }
+    Version *version = chunk[id & (CHUNK_SIZE - 1)].load(memory_order_acquire);
+    while (version != nullptr && version->since > epoch)
+    {
+        version = version->older.load(memory_order_acquire);
+    }
+    return version == nullptr ? nullptr : version->record;
+}
+
+void RecordVersions::publish(int id, const Person *record)
+{
+    if (id < 0)
+    {
+        return;
+    }
+    atomic<Head *> &chunk_slot = chunks[id >> CHUNK_BITS];
+    Head *chunk = chunk_slot.load(memory_order_relaxed);
+    if (chunk == nullptr)
+    {
+        chunk = new Head[CHUNK_SIZE];
+        MemoryAccounting::allocated(MEM_VERSIONS, CHUNK_SIZE * sizeof(Head));
+        for (uint32_t i = 0; i < CHUNK_SIZE; i++)
+        {
+            chunk[i].store(nullptr, memory_order_relaxed);
+        }
+        chunk_slot.store(chunk, memory_order_release);
+    }
+    Head &head = chunk[id & (CHUNK_SIZE - 1)];
+
+    // Link the new version in before moving the clock, a view pinned at the
+    // new epoch must find it
+    Version *older = head.load(memory_order_relaxed);
+    uint64_t epoch = clock.load(memory_order_relaxed) + 1;
+    Version *version = new Version(record, epoch, older);
+    head.store(version, memory_order_release);
+    clock.store(epoch);
+
+    if (older != nullptr)
+    {
+        retired.push_back({version, older, epoch});
+        reclaim();
+    }
+}
+
+size_t RecordVersions::reclaim()
+{
+    if (retired.empty())
+    {
+        return 0;
+    }
+    uint64_t oldest = clock.load();
+    for (ReaderSlot &reader : readers)
+    {
+        uint64_t pinned = reader.pinned.load();
+        if (pinned != 0 && pinned - 1 < oldest)
+        {
+            oldest = pinned - 1;
+        }
+    }
+
+    // Retired in epoch order, so everything older than the first survivor
+    // is gone already and unlinking from the newer version is enough
+    size_t freed = 0;
+    while (!retired.empty() && retired.front().until <= oldest)
+    {
+        Retired &entry = retired.front();
+        entry.newer->older.store(nullptr, memory_order_relaxed);
+        delete entry.version->record;
+        delete entry.version;
+        retired.pop_front();
+        freed++;
+    }
+    return freed;
+}
+
+void RecordVersions::clear()
+{
+    for (Retired &entry : retired)
+    {
+        delete entry.version->record;
+        delete entry.version;
+    }
+    retired.clear();
+    // Only the current versions are left, one per id
+    for (uint32_t i = 0; i < MAX_CHUNKS; i++)
+    {
+        Head *chunk = chunks[i].load(memory_order_relaxed);
+        if (chunk == nullptr)
+        {
+            continue;
+        }
+        for (uint32_t j = 0; j < CHUNK_SIZE; j++)
+        {
+            delete chunk[j].load(memory_order_relaxed);
+            chunk[j].store(nullptr, memory_order_relaxed);
+        }
+    }
+}
+
+uint64_t RecordVersions::getEpoch() const
+{
+    return clock.load();
+}
+
+size_t RecordVersions::retired_count() const
+{
+    return retired.size();
+}
+
+RecordVersions::~RecordVersions()
+{
+    clear();
+    for (uint32_t i = 0; i < MAX_CHUNKS; i++)
+    {
+        Head *chunk = chunks[i].load(memory_order_relaxed);
+        if (chunk != nullptr)
+        {
+            MemoryAccounting::released(MEM_VERSIONS, CHUNK_SIZE * sizeof(Head));
+            delete[] chunk;
+        }
+    }
+    MemoryAccounting::released(MEM_VERSIONS, MAX_CHUNKS * sizeof(atomic<Head *>));
+    delete[] chunks;
+}
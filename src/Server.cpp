@@ -0,0 +1,383 @@
+#include "Server.h"
+#include "RecordParser.h"
+#include "Snapshot.h"
+#include "Metrics.h"
+
+#include <iostream>
+#include <thread>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+const int SERVER_MAX_FIELDS = 7;
+const size_t SERVER_DEFAULT_LIMIT = 100;
+
+Server::Server(RecordStore &store, IdAllocator &ids, Journal &journal, const string &path)
+    : store(store), ids(ids), journal(journal), path(path), listen_fd(-1), stopping(false),
+      updates(store, ids, journal, update_out, update_out, 0)
+{
+}
+
+void Server::query(const vector<string> &fields, string &reply)
+{
+    const string &command = fields[0];
+    ostringstream out;
+    int number = 0, low = 0, high = 0;
+    size_t limit_field = 2;
+    vector<int> slots;
+
+    if (command == "get")
+    {
+        if (fields.size() != 2 || !parse_int(fields[1], number))
+        {
+            reply = "ERR get needs an id\n";
+            return;
+        }
+        // No lock: the record comes from a pinned epoch and stays valid
+        // until the view closes, whatever writers do meanwhile
+        ScopedTimer timer(TIMER_LOOKUP);
+        RecordVersions::ReadView view(versions);
+        const Person *person = view.find(number);
+        if (person == nullptr)
+        {
+            Metrics::count(COUNTER_LOOKUP_MISSES);
+            reply = "ERR no person with ID " + fields[1] + "\n";
+            return;
+        }
+        BatchRunner::write_record(out, person);
+        reply = out.str() + "OK\n";
+        return;
+    }
+
+    if (command == "metrics")
+    {
+        // metrics[`json]: Prometheus text unless JSON is asked for
+        if (fields.size() > 1 && fields[1] == "json")
+            Metrics::write_json(out);
+        else
+            Metrics::write_prometheus(out);
+        reply = out.str() + "OK\n";
+        return;
+    }
+
+    shared_lock<shared_mutex> guard(records);
+    if (command == "stats")
+    {
+        reply = "OK " + to_string(store.size()) + " " + to_string(ids.getHighWater()) + "\n";
+        return;
+    }
+
+    if (command != "find" && command != "prefix" && command != "subject" && command != "designation" &&
+        command != "age")
+    {
+        reply = "ERR unknown command '" + command + "'\n";
+        return;
+    }
+    if (fields.size() < 2)
+    {
+        reply = "ERR " + command + " needs an argument\n";
+        return;
+    }
+    if (command == "age")
+    {
+        if (fields.size() < 3 || !parse_int(fields[1], low) || !parse_int(fields[2], high))
+        {
+            reply = "ERR age needs min and max\n";
+            return;
+        }
+        limit_field = 3;
+    }
+
+    size_t limit = command == "find" ? 20 : SERVER_DEFAULT_LIMIT;
+    if (fields.size() > limit_field)
+    {
+        if (!parse_int(fields[limit_field], number) || number < 1)
+        {
+            reply = "ERR limit must be a positive number\n";
+            return;
+        }
+        limit = (size_t)number;
+    }
+
+    if (command == "find")
+        slots = store.find_by_name(fields[1], limit);
+    else if (command == "prefix")
+        slots = store.find_by_name_prefix(fields[1], limit);
+    else if (command == "subject")
+        slots = store.find_by_subject(fields[1]);
+    else if (command == "designation")
+        slots = store.find_by_designation(fields[1]);
+    else
+        slots = store.find_by_age(low, high);
+
+    if (slots.size() > limit)
+    {
+        slots.resize(limit);
+    }
+    for (int slot : slots)
+    {
+        BatchRunner::write_record(out, store.at(slot));
+    }
+    reply = out.str() + "OK " + to_string(slots.size()) + "\n";
+}
+
+void Server::update(const string &line, string &reply)
+{
+    string error, result;
+    long long position;
+    bool applied;
+    {
+        unique_lock<shared_mutex> guard(records);
+        update_out.str("");
+        applied = updates.execute(line, error);
+        result = update_out.str();
+        position = journal.getAppended();
+    }
+    if (!applied)
+    {
+        reply = "ERR " + error + "\n";
+        return;
+    }
+
+    // Readers are already running again while this waits for the disk
+    {
+        lock_guard<mutex> guard(durability);
+        if (!journal.sync_through(position))
+        {
+            reply = "ERR change applied but the journal could not be synced\n";
+            return;
+        }
+    }
+    if (journal.needs_compaction())
+    {
+        compact();
+    }
+    if (!result.empty() && result.back() == '\n')
+    {
+        result.pop_back();
+    }
+    reply = "OK " + result + "\n";
+}
+
+// Fold the journal into the snapshot. Queries keep running, only writers
+// wait, since the snapshot just reads the store.
+void Server::compact()
+{
+    shared_lock<shared_mutex> readers(records);
+    lock_guard<mutex> guard(durability);
+    if (journal.needs_compaction() && save_snapshot(store, ids))
+    {
+        journal.reset();
+    }
+}
+
+void Server::handle(const string &line, string &reply)
+{
+    string_view views[SERVER_MAX_FIELDS];
+    int count = split_record(line, views, SERVER_MAX_FIELDS);
+    const string_view command = views[0];
+
+    if (command == "add" || command == "modify" || command == "delete")
+    {
+        update(line, reply);
+    }
+    else if (command == "commit")
+    {
+        lock_guard<mutex> guard(durability);
+        reply = journal.sync_through(journal.getAppended()) ? "OK\n" : "ERR journal sync failed\n";
+    }
+    else
+    {
+        query(vector<string>(views, views + count), reply);
+    }
+}
+
+#ifdef _WIN32
+
+bool Server::start()
+{
+    cerr << "Server mode needs Unix domain sockets and is not available on Windows." << endl;
+    return false;
+}
+
+void Server::run() {}
+void Server::serve_client(int) {}
+
+#else
+
+bool Server::start()
+{
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path))
+    {
+        cerr << "Socket path too long: " << path << endl;
+        return false;
+    }
+    strcpy(address.sun_path, path.c_str());
+
+    // A client that goes away mid-reply must not kill the server
+    signal(SIGPIPE, SIG_IGN);
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0)
+    {
+        cerr << "Cannot create socket." << endl;
+        return false;
+    }
+    // A socket file nobody answers on is left over from a crash
+    if (connect(listen_fd, (sockaddr *)&address, sizeof(address)) == 0)
+    {
+        cerr << "Another server is already running on " << path << endl;
+        close(listen_fd);
+        listen_fd = -1;
+        return false;
+    }
+    close(listen_fd);
+    unlink(path.c_str());
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0 || bind(listen_fd, (sockaddr *)&address, sizeof(address)) != 0 || listen(listen_fd, 64) != 0)
+    {
+        cerr << "Cannot listen on " << path << ": " << strerror(errno) << endl;
+        if (listen_fd >= 0)
+        {
+            close(listen_fd);
+            listen_fd = -1;
+        }
+        return false;
+    }
+    return true;
+}
+
+static bool send_all(int fd, const string &data)
+{
+    size_t sent = 0;
+    while (sent < data.size())
+    {
+        ssize_t result = send(fd, data.data() + sent, data.size() - sent, 0);
+        if (result <= 0)
+        {
+            if (result < 0 && errno == EINTR)
+                continue;
+            return false;
+        }
+        sent += (size_t)result;
+    }
+    return true;
+}
+
+void Server::serve_client(int fd)
+{
+    string pending, replies, reply;
+    char buffer[4096];
+    bool open = true;
+    while (open && !stopping)
+    {
+        ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+        if (received <= 0)
+        {
+            if (received < 0 && errno == EINTR)
+                continue;
+            break;
+        }
+        pending.append(buffer, (size_t)received);
+
+        // Answer every complete line, replies to a pipelined burst go out together
+        size_t start = 0, end;
+        replies.clear();
+        while (open && (end = pending.find('\n', start)) != string::npos)
+        {
+            string line = pending.substr(start, end - start);
+            start = end + 1;
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+            if (line.empty())
+            {
+                continue;
+            }
+            if (line == "quit")
+            {
+                open = false;
+                break;
+            }
+            handle(line, reply);
+            replies += reply;
+        }
+        pending.erase(0, start);
+        if (!send_all(fd, replies))
+        {
+            break;
+        }
+    }
+
+    lock_guard<mutex> guard(clients_lock);
+    clients.erase(fd);
+    close(fd);
+    clients_done.notify_all();
+}
+
+void Server::run()
+{
+    store.publish_to(&versions);
+    while (!stopping)
+    {
+        pollfd waiting = {listen_fd, POLLIN, 0};
+        if (poll(&waiting, 1, 200) <= 0)
+        {
+            continue;
+        }
+        int fd = accept(listen_fd, nullptr, nullptr);
+        if (fd < 0)
+        {
+            continue;
+        }
+        lock_guard<mutex> guard(clients_lock);
+        clients.insert(fd);
+        thread(&Server::serve_client, this, fd).detach();
+    }
+
+    close(listen_fd);
+    listen_fd = -1;
+    unlink(path.c_str());
+
+    // Wake every connection blocked in recv and wait for it to finish
+    unique_lock<mutex> guard(clients_lock);
+    for (int fd : clients)
+    {
+        shutdown(fd, SHUT_RDWR);
+    }
+    clients_done.wait(guard, [this]() { return clients.empty(); });
+    // Nobody can read any more, old versions can go
+    store.publish_to(nullptr);
+}
+
+#endif
+
+void Server::stop()
+{
+    stopping = true;
+}
+
+Server::~Server()
+{
+#ifndef _WIN32
+    if (listen_fd >= 0)
+    {
+        close(listen_fd);
+        unlink(path.c_str());
+    }
+#endif
+}
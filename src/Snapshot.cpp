@@ -0,0 +1,525 @@
+#include "Snapshot.h"
+#include "Database_handler.h"
+#include "Person.h"
+#include "Teacher.h"
+#include "Staff.h"
+#include "StringTable.h"
+
+#include <iostream>
+#include <vector>
+#include <cstdio>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#include <fcntl.h>
+#define open_create(path) _open(path, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE)
+#define write_fd _write
+#define close_fd _close
+#define sync_fd _commit
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define open_create(path) ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644)
+#define write_fd ::write
+#define close_fd ::close
+#define sync_fd ::fsync
+#endif
+
+using namespace std;
+
+// Read-only memory mapping of a whole file
+class MappedFile
+{
+private:
+    const char *data;
+    size_t length;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+
+public:
+    MappedFile() : data(nullptr), length(0)
+    {
+#ifdef _WIN32
+        file = INVALID_HANDLE_VALUE;
+        mapping = NULL;
+#endif
+    }
+
+    bool open(const string &path)
+    {
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0)
+        {
+            return false;
+        }
+        length = (size_t)file_size.QuadPart;
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping == NULL)
+        {
+            return false;
+        }
+        data = (const char *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        return data != nullptr;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0)
+        {
+            ::close(fd);
+            return false;
+        }
+        length = (size_t)info.st_size;
+        void *mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED)
+        {
+            return false;
+        }
+        madvise(mapped, length, MADV_SEQUENTIAL);
+        data = (const char *)mapped;
+        return true;
+#endif
+    }
+
+    const char *begin() const { return data; }
+    size_t size() const { return length; }
+
+    ~MappedFile()
+    {
+#ifdef _WIN32
+        if (data != nullptr)
+            UnmapViewOfFile(data);
+        if (mapping != NULL)
+            CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE)
+            CloseHandle(file);
+#else
+        if (data != nullptr)
+            munmap((void *)data, length);
+#endif
+    }
+};
+
+static SnapshotString add_to_heap(string &heap, const string &value)
+{
+    SnapshotString handle;
+    handle.offset = (uint32_t)heap.size();
+    handle.length = (uint32_t)value.size();
+    heap += value;
+    return handle;
+}
+
+static bool write_all(int fd, const char *data, size_t length)
+{
+    while (length > 0)
+    {
+        // Windows takes an unsigned int count, so write in slices
+        unsigned int slice = length > (1u << 30) ? (1u << 30) : (unsigned int)length;
+        long written = (long)write_fd(fd, data, slice);
+        if (written <= 0)
+        {
+            return false;
+        }
+        data += written;
+        length -= (size_t)written;
+    }
+    return true;
+}
+
+// Make a rename inside the directory holding path durable
+static bool sync_directory(const string &path)
+{
+#ifdef _WIN32
+    (void)path;
+    return true;
+#else
+    size_t slash = path.rfind('/');
+    string directory = slash == string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+    int fd = ::open(directory.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+    return synced;
+#endif
+}
+
+static string from_heap(const char *heap, const SnapshotString &handle)
+{
+    return string(heap + handle.offset, handle.length);
+}
+
+// Number an interned value for the snapshot's string table, storing its
+// text in the heap the first time a record uses it
+static uint32_t number_string(StringHandle handle, vector<uint32_t> &numbers, vector<SnapshotString> &strings,
+                              string &heap)
+{
+    if (handle >= numbers.size())
+    {
+        numbers.resize(handle + 1, UINT32_MAX);
+    }
+    if (numbers[handle] == UINT32_MAX)
+    {
+        numbers[handle] = (uint32_t)strings.size();
+        strings.push_back(add_to_heap(heap, StringTable::shared().get(handle)));
+    }
+    return numbers[handle];
+}
+
+bool save_snapshot(const RecordStore &store, const IdAllocator &ids, const string &path, bool text_current)
+{
+    ensureDataDirectory();
+
+    vector<SnapshotRecord> records;
+    records.reserve(store.size());
+    vector<SnapshotString> strings;
+    vector<uint32_t> numbers(StringTable::shared().size(), UINT32_MAX);
+    string heap;
+
+    for (Person *person : store)
+    {
+        SnapshotRecord record;
+        memset(&record, 0, sizeof(record));
+        record.id = person->getId();
+        record.age = person->getAge();
+        record.kind = person->getKind();
+        record.name = add_to_heap(heap, person->getName());
+        record.phone = add_to_heap(heap, person->getPhone());
+        record.address = number_string(person->getAddressHandle(), numbers, strings, heap);
+
+        StringHandle extra = 0;
+        if (record.kind == KIND_TEACHER)
+        {
+            extra = static_cast<Teacher *>(person)->getSubjectHandle();
+        }
+        else if (record.kind == KIND_STAFF)
+        {
+            extra = static_cast<Staff *>(person)->getDesignationHandle();
+        }
+        record.extra = number_string(extra, numbers, strings, heap);
+        records.push_back(record);
+    }
+    vector<int> free_ids = ids.free_list();
+
+    if (heap.size() > UINT32_MAX)
+    {
+        cerr << "Error: roster too large for snapshot string heap." << endl;
+        return false;
+    }
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "SMSB", 4);
+    header.version = SNAPSHOT_VERSION;
+    header.header_size = sizeof(SnapshotHeader);
+    header.record_size = sizeof(SnapshotRecord);
+    header.record_count = records.size();
+    header.heap_size = heap.size();
+    header.high_water = ids.getHighWater();
+    header.string_count = (uint32_t)strings.size();
+    header.free_count = (uint32_t)free_ids.size();
+    header.flags = text_current ? SNAPSHOT_TEXT_CURRENT : 0;
+
+    // Write to a temporary file first so a crash never leaves a torn
+    // snapshot. Only once the data, the rename and the directory entry are
+    // on disk may the caller drop the journal.
+    string temp_path = path + ".tmp";
+    int fd = open_create(temp_path.c_str());
+    if (fd < 0)
+    {
+        cerr << "Error opening snapshot for writing." << endl;
+        return false;
+    }
+    bool written = write_all(fd, (const char *)&header, sizeof(header)) &&
+                   write_all(fd, (const char *)records.data(), records.size() * sizeof(SnapshotRecord)) &&
+                   write_all(fd, (const char *)strings.data(), strings.size() * sizeof(SnapshotString)) &&
+                   write_all(fd, (const char *)free_ids.data(), free_ids.size() * sizeof(int32_t)) &&
+                   write_all(fd, heap.data(), heap.size()) && sync_fd(fd) == 0;
+    written = close_fd(fd) == 0 && written;
+    if (!written)
+    {
+        cerr << "Error writing snapshot." << endl;
+        remove(temp_path.c_str());
+        return false;
+    }
+
+#ifdef _WIN32
+    // rename() does not replace an existing file here
+    remove(path.c_str());
+#endif
+    if (rename(temp_path.c_str(), path.c_str()) != 0)
+    {
+        cerr << "Error replacing snapshot." << endl;
+        remove(temp_path.c_str());
+        return false;
+    }
+    if (!sync_directory(path))
+    {
+        cerr << "Error syncing snapshot directory." << endl;
+        return false;
+    }
+    return true;
+}
+
+// Version 1 record, every field in the heap
+struct SnapshotRecordV1 {
+    int32_t id;
+    int32_t age;
+    uint8_t kind;
+    uint8_t reserved[7];
+    SnapshotString name;
+    SnapshotString phone;
+    SnapshotString address;
+    SnapshotString extra;
+};
+const uint32_t SNAPSHOT_HEADER_SIZE_V1 = offsetof(SnapshotHeader, string_count) + sizeof(uint32_t);
+
+static bool in_heap(const SnapshotString &value, uint64_t heap_size)
+{
+    return (uint64_t)value.offset + value.length <= heap_size;
+}
+
+static void read_records_v1(RecordStore &store, IdAllocator &ids, const SnapshotHeader &header, const char *base)
+{
+    const SnapshotRecordV1 *records = (const SnapshotRecordV1 *)(base + header.header_size);
+    const char *heap = base + header.header_size + header.record_count * header.record_size;
+
+    for (uint64_t i = 0; i < header.record_count; i++)
+    {
+        const SnapshotRecordV1 &record = records[i];
+        if (!in_heap(record.name, header.heap_size) || !in_heap(record.phone, header.heap_size) ||
+            !in_heap(record.address, header.heap_size) || !in_heap(record.extra, header.heap_size))
+        {
+            cerr << "Corrupt snapshot record skipped (ID " << record.id << ")." << endl;
+            continue;
+        }
+
+        Person *person = Person::create((PersonKind)record.kind);
+        if (person == nullptr)
+        {
+            cerr << "Unknown record kind in snapshot skipped (ID " << record.id << ")." << endl;
+            continue;
+        }
+        try
+        {
+            if (record.kind != KIND_STUDENT)
+            {
+                // Base class setters ignore the field for the other kinds
+                string extra = from_heap(heap, record.extra);
+                person->setSubject(extra);
+                person->setDesignation(move(extra));
+            }
+            person->setAddress(from_heap(heap, record.address));
+        }
+        catch (const length_error &)
+        {
+            delete person;
+            throw;
+        }
+        person->setName(from_heap(heap, record.name));
+        person->setAge(record.age);
+        person->setPhone(from_heap(heap, record.phone));
+        person->setId(record.id);
+
+        ids.seed(record.id);
+        store.insert(person);
+    }
+}
+
+static bool read_records(RecordStore &store, IdAllocator &ids, const SnapshotHeader &header, const char *base)
+{
+    const SnapshotRecord *records = (const SnapshotRecord *)(base + header.header_size);
+    const SnapshotString *strings = (const SnapshotString *)(records + header.record_count);
+    const int32_t *free_ids = (const int32_t *)(strings + header.string_count);
+    const char *heap = (const char *)(free_ids + header.free_count);
+
+    // Each distinct value is interned once, records then take its handle
+    vector<StringHandle> handles(header.string_count);
+    StringTable &table = StringTable::shared();
+    table.reserve(header.string_count);
+    for (uint32_t i = 0; i < header.string_count; i++)
+    {
+        if (!in_heap(strings[i], header.heap_size))
+        {
+            cerr << "Corrupt snapshot string table, ignoring the snapshot." << endl;
+            return false;
+        }
+        handles[i] = table.intern(string_view(heap + strings[i].offset, strings[i].length));
+    }
+
+    for (uint64_t i = 0; i < header.record_count; i++)
+    {
+        const SnapshotRecord &record = records[i];
+        if (!in_heap(record.name, header.heap_size) || !in_heap(record.phone, header.heap_size) ||
+            record.address >= header.string_count || record.extra >= header.string_count)
+        {
+            cerr << "Corrupt snapshot record skipped (ID " << record.id << ")." << endl;
+            continue;
+        }
+
+        Person *person = Person::create((PersonKind)record.kind);
+        if (person == nullptr)
+        {
+            cerr << "Unknown record kind in snapshot skipped (ID " << record.id << ")." << endl;
+            continue;
+        }
+        person->setName(from_heap(heap, record.name));
+        person->setAge(record.age);
+        person->setPhone(from_heap(heap, record.phone));
+        person->setAddressHandle(handles[record.address]);
+        person->setId(record.id);
+        if (record.kind == KIND_TEACHER)
+        {
+            static_cast<Teacher *>(person)->setSubjectHandle(handles[record.extra]);
+        }
+        else if (record.kind == KIND_STAFF)
+        {
+            static_cast<Staff *>(person)->setDesignationHandle(handles[record.extra]);
+        }
+
+        ids.seed(record.id);
+        store.insert(person);
+    }
+
+    // Oldest first, so the ID handed out next is the same as before
+    for (uint32_t i = 0; i < header.free_count; i++)
+    {
+        if (store.find(free_ids[i]) < 0)
+        {
+            ids.release(free_ids[i]);
+        }
+    }
+    return true;
+}
+
+bool read_snapshot(RecordStore &store, IdAllocator &ids, const string &path)
+{
+    MappedFile file;
+    if (!file.open(path))
+    {
+        return false;
+    }
+
+    if (file.size() < SNAPSHOT_HEADER_SIZE_V1)
+    {
+        cerr << "Snapshot is truncated, ignoring it." << endl;
+        return false;
+    }
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(&header, file.begin(), file.size() < sizeof(header) ? SNAPSHOT_HEADER_SIZE_V1 : sizeof(header));
+
+    bool version_1 = header.version == 1 && header.header_size == SNAPSHOT_HEADER_SIZE_V1 &&
+                     header.record_size == sizeof(SnapshotRecordV1);
+    if (version_1)
+    {
+        header.string_count = 0;
+        header.free_count = 0;
+    }
+    if (memcmp(header.magic, "SMSB", 4) != 0 ||
+        (!version_1 && (header.version != SNAPSHOT_VERSION || header.header_size != sizeof(SnapshotHeader) ||
+                        header.record_size != sizeof(SnapshotRecord))))
+    {
+        cerr << "Snapshot format not recognized, ignoring it." << endl;
+        return false;
+    }
+    uint64_t expected = header.header_size + header.record_count * header.record_size +
+                        (uint64_t)header.string_count * sizeof(SnapshotString) +
+                        (uint64_t)header.free_count * sizeof(int32_t) + header.heap_size;
+    if (expected != file.size())
+    {
+        cerr << "Snapshot size mismatch, ignoring it." << endl;
+        return false;
+    }
+
+    // The indexes are built once, after the last record
+    store.reserve(store.size() + (int)header.record_count);
+    store.begin_bulk_load();
+    ids.seed(header.high_water);
+    bool loaded = true;
+    try
+    {
+        if (version_1)
+        {
+            read_records_v1(store, ids, header, file.begin());
+        }
+        else
+        {
+            loaded = read_records(store, ids, header, file.begin());
+        }
+    }
+    catch (const length_error &e)
+    {
+        cerr << "Snapshot cannot be loaded: " << e.what() << "." << endl;
+        loaded = false;
+    }
+    store.end_bulk_load();
+    return loaded;
+}
+
+static bool modified_time(const string &path, time_t &when)
+{
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0)
+    {
+        return false;
+    }
+    when = info.st_mtime;
+    return true;
+}
+
+bool snapshot_is_current(const string &path)
+{
+    time_t snapshot_time;
+    if (!modified_time(path, snapshot_time))
+    {
+        return false;
+    }
+    const char *text_files[] = {"../data/students.txt", "../data/teachers.txt", "../data/staff.txt"};
+    for (const char *text_file : text_files)
+    {
+        time_t text_time;
+        if (modified_time(text_file, text_time) && text_time > snapshot_time)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool snapshot_ahead_of_text(const string &path)
+{
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    size_t read = fread(&header, 1, sizeof(header), file);
+    fclose(file);
+    // Version 1 had no flag, so it is treated like an unreadable header
+    bool flagged = read == sizeof(header) && memcmp(header.magic, "SMSB", 4) == 0 &&
+                   header.version == SNAPSHOT_VERSION && (header.flags & SNAPSHOT_TEXT_CURRENT) != 0;
+    return !flagged;
+}
@@ -1,15 +1,21 @@
 #include "Staff.h"
 #include "Utility.h"
+#include "RecordStore.h"
 #include <iostream>
+#include <utility>
 using namespace std;
 
-int Staff::count = 0;
+atomic<int> Staff::count(0);
 
-Staff::Staff() : Person()
+Staff::Staff() : Person(KIND_STAFF)
+{
+    count++;
+    designation = 0;
+}
+
+Staff::Staff(const Staff &other) : Person(other), designation(other.designation)
 {
     count++;
-    setType("Staff");
-    designation = "";
 }
 
 void Staff::printDetails()
@@ -19,56 +25,51 @@ void Staff::printDetails()
          << "Age: " << getAge() << "\n"
          << "Phone: " << getPhone() << "\n"
          << "Address: " << getAddress() << "\n"
-         << "Designation: " << designation << "\n"
+         << "Designation: " << getDesignation() << "\n"
          << "Staff ID: " << getId() << endl;
 }
 
-int Staff::get_by_id(int id, Person **data)
+int Staff::get_by_id(int id, RecordStore &store)
 {
-    for (int i = 0; i < 100; i++)
+    int index = store.find(id);
+    if (index != -1 && store.at(index)->getKind() == KIND_STAFF)
     {
-        if (data[i] != nullptr && data[i]->getId() == id && data[i]->printType() == "Staff")
-        {
-            cout << data[i]->printType() << endl;
-            data[i]->printDetails();
-            return i;
-        }
+        cout << store.at(index)->printType() << endl;
+        store.at(index)->printDetails();
+        return index;
     }
     return -1;
 }
 
-bool Staff::save(Person **data, int index)
+bool Staff::save(RecordStore &store, int index)
 {
     if (index == -1)
     {
-        for (int i = 0; i < 100; i++)
-        {
-            if (data[i] == nullptr)
-            {
-                data[i] = this;
-                return true;
-            }
-        }
-        return false;
+        store.insert(this);
     }
     else
     {
-        data[index] = this;
-        return true;
+        store.replace(index, this);
     }
+    return true;
 }
 
+Person *Staff::clone() const { return new Staff(*this); }
+
 void Staff::get_specific_inputs()
 {
     this->setDesignation(Utility::take_string_input("Designation"));
 }
 
 int Staff::getCount() { return count; }
-string Staff::getDesignation() { return designation; }
 
-void Staff::setDesignation(const string& designation) 
+const string &Staff::getDesignation() const { return StringTable::shared().get(designation); }
+StringHandle Staff::getDesignationHandle() const { return designation; }
+void Staff::setDesignationHandle(StringHandle designation) { this->designation = designation; }
+
+void Staff::setDesignation(string designation) 
 { 
-    this->designation = designation; 
+    this->designation = StringTable::shared().intern(move(designation)); 
 }
 
 
@@ -0,0 +1,119 @@
+#include "StringTable.h"
+#include "MemoryAccounting.h"
+
+#include <utility>
+#include <stdexcept>
+
+using namespace std;
+
+StringTable::StringTable(uint32_t capacity) : chunks(MAX_CHUNKS, nullptr), capacity(capacity), count(0), value_bytes(0)
+{
+    if (this->capacity > MAX_VALUES)
+    {
+        this->capacity = MAX_VALUES;
+    }
+    this->capacity++;       // The empty string does not count
+    store(string());
+}
+
+StringHandle StringTable::store(string &&value)
+{
+    if (count >= capacity)
+    {
+        throw length_error("too many distinct field values (limit " + to_string(capacity) + ")");
+    }
+    uint32_t chunk = count >> CHUNK_BITS;
+    if (chunks[chunk] == nullptr)
+    {
+        chunks[chunk] = new string[CHUNK_SIZE];
+    }
+    StringHandle handle = count++;
+    string &slot = chunks[chunk][handle & (CHUNK_SIZE - 1)];
+    slot = move(value);
+    value_bytes += MemoryAccounting::heap_bytes(slot);
+    index.emplace(string_view(slot), handle);
+    return handle;
+}
+
+StringHandle StringTable::intern(string_view value)
+{
+    lock_guard<mutex> guard(lock);
+    unordered_map<string_view, StringHandle>::const_iterator it = index.find(value);
+    if (it != index.end())
+    {
+        return it->second;
+    }
+    return store(string(value));
+}
+
+StringHandle StringTable::intern(string &&value)
+{
+    lock_guard<mutex> guard(lock);
+    unordered_map<string_view, StringHandle>::const_iterator it = index.find(string_view(value));
+    if (it != index.end())
+    {
+        return it->second;
+    }
+    return store(move(value));
+}
+
+void StringTable::intern(const string_view *values, size_t count, StringHandle *handles)
+{
+    lock_guard<mutex> guard(lock);
+    for (size_t i = 0; i < count; i++)
+    {
+        unordered_map<string_view, StringHandle>::const_iterator it = index.find(values[i]);
+        handles[i] = it != index.end() ? it->second : store(string(values[i]));
+    }
+}
+
+void StringTable::reserve(size_t count)
+{
+    lock_guard<mutex> guard(lock);
+    index.reserve(index.size() + count);
+}
+
+bool StringTable::find(string_view value, StringHandle &handle) const
+{
+    lock_guard<mutex> guard(lock);
+    unordered_map<string_view, StringHandle>::const_iterator it = index.find(value);
+    if (it == index.end())
+    {
+        return false;
+    }
+    handle = it->second;
+    return true;
+}
+
+size_t StringTable::size() const
+{
+    lock_guard<mutex> guard(lock);
+    return count;
+}
+
+size_t StringTable::bytes() const
+{
+    lock_guard<mutex> guard(lock);
+    size_t allocated_chunks = (count + CHUNK_SIZE - 1) >> CHUNK_BITS;
+    // Chunks, heap buffers of long values (counted as they are stored),
+    // and roughly one hash node
+    // (key, handle, next pointer, cached hash) plus a bucket per value
+    return MAX_CHUNKS * sizeof(string *) + allocated_chunks * CHUNK_SIZE * sizeof(string) + value_bytes +
+           index.size() * (sizeof(string_view) + sizeof(StringHandle) + 2 * sizeof(void *)) +
+           index.bucket_count() * sizeof(void *);
+}
+
+StringTable &StringTable::shared()
+{
+    // Never destroyed, like the record pools
+    static StringTable *instance = new StringTable();
+    return *instance;
+}
+
+StringTable::~StringTable()
+{
+    for (string *chunk : chunks)
+    {
+        delete[] chunk;
+    }
+}
@@ -1,15 +1,19 @@
 #include "Student.h"
 #include "Utility.h"
+#include "RecordStore.h"
 #include <iostream>
-#include <conio.h>
 using namespace std;
 
-int Student::count = 0;
+atomic<int> Student::count(0);
 
-Student::Student() : Person()
+Student::Student() : Person(KIND_STUDENT)
+{
+    count++;
+}
+
+Student::Student(const Student &other) : Person(other)
 {
     count++;
-    setType("Student");
 }
 
 void Student::printDetails()
@@ -22,42 +26,35 @@ void Student::printDetails()
          << "Student ID: " << getId() << endl;
 }
 
-int Student::get_by_id(int id, Person **data)
+int Student::get_by_id(int id, RecordStore &store)
 {
-    for (int i = 0; i < 100; i++)
+    int index = store.find(id);
+    if (index != -1 && store.at(index)->getKind() == KIND_STUDENT)
     {
-        if (data[i] != nullptr && data[i]->getId() == id && data[i]->printType() == "Student")
-        {
-            cout << data[i]->printType() << endl;
-            data[i]->printDetails();
-            return i;
-        }
+        cout << store.at(index)->printType() << endl;
+        store.at(index)->printDetails();
+        return index;
     }
     return -1;
 }
 
-bool Student::save(Person **data, int index)
+bool Student::save(RecordStore &store, int index)
 {
     if (index == -1)
     {
-        for (int i = 0; i < 100; i++)
-        {
-            if (data[i] == nullptr)
-            {
-                data[i] = this;
-                return true;
-            }
-        }
-        return false;
+        store.insert(this);
     }
     else
     {
-        data[index] = this;
-        return true;
+        store.replace(index, this);
     }
+    return true;
 }
 
+Person *Student::clone() const { return new Student(*this); }
+
 int Student::getCount() { return count; }
+
 void Student::get_specific_inputs() {
     // Students don't need additional specific inputs beyond common ones
 }
@@ -1,15 +1,21 @@
 #include "Teacher.h"
 #include "Utility.h"
+#include "RecordStore.h"
 #include <iostream>
+#include <utility>
 using namespace std;
 
-int Teacher::count = 0;
+atomic<int> Teacher::count(0);
 
-Teacher::Teacher() : Person()
+Teacher::Teacher() : Person(KIND_TEACHER)
+{
+    count++;
+    subject = 0;
+}
+
+Teacher::Teacher(const Teacher &other) : Person(other), subject(other.subject)
 {
     count++;
-    setType("Teacher");
-    subject = "";
 }
 
 void Teacher::printDetails()
@@ -19,63 +25,66 @@ void Teacher::printDetails()
          << "Age: " << getAge() << "\n"
          << "Phone: " << getPhone() << "\n"
          << "Address: " << getAddress() << "\n"
-         << "Subject: " << subject << "\n"
+         << "Subject: " << getSubject() << "\n"
          << "Teacher ID: " << getId() << endl;
 }
 
 
-void Teacher::setSubject(const string &subject)
+void Teacher::setSubject(string subject)
 {
-    this->subject = subject;
+    this->subject = StringTable::shared().intern(move(subject));
 }
 
 
-string Teacher::getSubject() const
+StringHandle Teacher::getSubjectHandle() const
 {
     return subject;
 }
 
-int Teacher::get_by_id(int id, Person **data)
+void Teacher::setSubjectHandle(StringHandle subject)
+{
+    this->subject = subject;
+}
+
+const string &Teacher::getSubject() const
 {
-    for (int i = 0; i < 100; i++)
+    return StringTable::shared().get(subject);
+}
+
+int Teacher::get_by_id(int id, RecordStore &store)
+{
+    int index = store.find(id);
+    if (index != -1 && store.at(index)->getKind() == KIND_TEACHER)
     {
-        if (data[i] != nullptr && data[i]->getId() == id && data[i]->printType() == "Teacher")
-        {
-            cout << data[i]->printType() << endl;
-            data[i]->printDetails();
-            return i;
-        }
+        cout << store.at(index)->printType() << endl;
+        store.at(index)->printDetails();
+        return index;
     }
     return -1;
 }
 
-bool Teacher::save(Person **data, int index)
+bool Teacher::save(RecordStore &store, int index)
 {
     if (index == -1)
     {
-        for (int i = 0; i < 100; i++)
-        {
-            if (data[i] == nullptr)
-            {
-                data[i] = this;
-                return true;
-            }
-        }
-        return false;
+        store.insert(this);
     }
     else
     {
-        data[index] = this;
-        return true;
+        store.replace(index, this);
     }
+    return true;
 }
 
+Person *Teacher::clone() const { return new Teacher(*this); }
+
 void Teacher::get_specific_inputs()
 {
     this->setSubject(Utility::take_string_input("Subject"));
 }
 
 int Teacher::getCount() { return count; }
+
 Teacher::~Teacher() {
     this->count--;
 }
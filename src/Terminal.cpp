@@ -0,0 +1,145 @@
+#include "Terminal.h"
+
+#include <iostream>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <conio.h>
+#ifndef ENABLE_VIRTUAL_TERMINAL_PROCESSING
+#define ENABLE_VIRTUAL_TERMINAL_PROCESSING 0x0004
+#endif
+#else
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+bool Terminal::vt_enabled = true;
+bool Terminal::initialized = false;
+
+// Foreground codes indexed by Utility::Colors
+static const char *const COLOR_CODES[16] = {
+    "\033[30m", // Black
+    "\033[34m", // Dark Blue
+    "\033[32m", // Dark Green
+    "\033[36m", // Dark Cyan
+    "\033[31m", // Dark Red
+    "\033[35m", // Dark Magenta
+    "\033[33m", // Dark Yellow
+    "\033[37m", // Light Gray
+    "\033[90m", // Dark Gray
+    "\033[94m", // Blue
+    "\033[92m", // Green
+    "\033[96m", // Cyan
+    "\033[91m", // Red
+    "\033[95m", // Magenta
+    "\033[93m", // Yellow
+    "\033[97m", // White
+};
+
+void Terminal::init()
+{
+    if (initialized)
+    {
+        return;
+    }
+    initialized = true;
+#ifdef _WIN32
+    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD mode = 0;
+    if (!GetConsoleMode(hConsole, &mode))
+    {
+        // Redirected to a file or pipe, plain escape codes are fine
+        vt_enabled = true;
+        return;
+    }
+    vt_enabled = SetConsoleMode(hConsole, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING) != 0;
+#else
+    vt_enabled = true;
+#endif
+}
+
+bool Terminal::supports_vt()
+{
+    init();
+    return vt_enabled;
+}
+
+void Terminal::clear_screen(ostream &out)
+{
+    // Clear screen and scrollback, then home the cursor
+    out << "\033[2J\033[3J\033[H";
+}
+
+void Terminal::move_cursor(ostream &out, int row, int col)
+{
+    out << "\033[" << row << ';' << col << 'H';
+}
+
+void Terminal::set_color(ostream &out, int color)
+{
+    if (color < 0 || color > 15)
+    {
+        color = 7;
+    }
+    out << COLOR_CODES[color];
+}
+
+void Terminal::reset_color(ostream &out)
+{
+    out << "\033[0m";
+}
+
+void Terminal::legacy_clear_screen()
+{
+#ifdef _WIN32
+    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (!GetConsoleScreenBufferInfo(hConsole, &info))
+    {
+        return;
+    }
+    DWORD cells = info.dwSize.X * info.dwSize.Y;
+    DWORD written;
+    COORD home = {0, 0};
+    FillConsoleOutputCharacterA(hConsole, ' ', cells, home, &written);
+    FillConsoleOutputAttribute(hConsole, info.wAttributes, cells, home, &written);
+    SetConsoleCursorPosition(hConsole, home);
+#endif
+}
+
+void Terminal::legacy_set_color(int color)
+{
+#ifdef _WIN32
+    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
+    SetConsoleTextAttribute(hConsole, color);
+#else
+    (void)color;
+#endif
+}
+
+int Terminal::read_key()
+{
+    cout.flush();
+#ifdef _WIN32
+    return _getch();
+#else
+    termios saved;
+    if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &saved) != 0)
+    {
+        return getchar();
+    }
+    // Non-canonical mode delivers the key at once, without Enter or echo
+    termios raw = saved;
+    raw.c_lflag &= ~(ICANON | ECHO);
+    raw.c_cc[VMIN] = 1;
+    raw.c_cc[VTIME] = 0;
+    tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+    unsigned char key;
+    ssize_t received = read(STDIN_FILENO, &key, 1);
+    tcsetattr(STDIN_FILENO, TCSANOW, &saved);
+    return received == 1 ? key : EOF;
+#endif
+}
@@ -0,0 +1,56 @@
+#include "ThreadPool.h"
+
+#include <thread>
+#include <atomic>
+#include <vector>
+
+using namespace std;
+
+ThreadPool::ThreadPool(int workers) : workers(workers)
+{
+    if (this->workers <= 0)
+    {
+        this->workers = (int)thread::hardware_concurrency();
+    }
+    if (this->workers <= 0)
+    {
+        this->workers = 1;
+    }
+}
+
+void ThreadPool::run(int task_count, const function<void(int)> &task)
+{
+    int thread_count = workers < task_count ? workers : task_count;
+    if (thread_count <= 1)
+    {
+        for (int i = 0; i < task_count; i++)
+        {
+            task(i);
+        }
+        return;
+    }
+
+    atomic<int> next(0);
+    auto worker = [&]()
+    {
+        int index;
+        while ((index = next.fetch_add(1)) < task_count)
+        {
+            task(index);
+        }
+    };
+
+    // The calling thread works too
+    vector<thread> threads;
+    for (int i = 1; i < thread_count; i++)
+    {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (thread &t : threads)
+    {
+        t.join();
+    }
+}
+
+int ThreadPool::getWorkers() const { return workers; }
@@ -1,8 +1,11 @@
 #include "Utility.h"
+#include "FrameBuffer.h"
+#include "Terminal.h"
 #include <string>
 #include <vector>
 #include <iostream>
 #include <iomanip>
+#include <limits>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -11,138 +14,131 @@
 
 using namespace std;
 
+// Every print_* call composes into this frame and is written in one go
+static FrameBuffer frame;
+
+ostream &Utility::out() { return frame.out(); }
+void Utility::begin_frame() { frame.begin(); }
+void Utility::end_frame() { frame.end(); }
+
 void Utility::set_console_color(int color)
 {
-#ifdef _WIN32
-    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
-    SetConsoleTextAttribute(hConsole, color);
-#else
-    switch(color) {
-        case 0: cout << "\033[30m"; break;  // Black
-        case 1: cout << "\033[34m"; break;  // Dark Blue
-        case 2: cout << "\033[32m"; break;  // Dark Green
-        case 3: cout << "\033[36m"; break;  // Dark Cyan
-        case 4: cout << "\033[31m"; break;  // Dark Red
-        case 5: cout << "\033[35m"; break;  // Dark Magenta
-        case 6: cout << "\033[33m"; break;  // Dark Yellow
-        case 7: cout << "\033[37m"; break;  // Light Gray
-        case 8: cout << "\033[90m"; break;  // Dark Gray
-        case 9: cout << "\033[94m"; break;  // Blue
-        case 10: cout << "\033[92m"; break; // Green
-        case 11: cout << "\033[96m"; break; // Cyan
-        case 12: cout << "\033[91m"; break; // Red
-        case 13: cout << "\033[95m"; break; // Magenta
-        case 14: cout << "\033[93m"; break; // Yellow
-        case 15: cout << "\033[97m"; break; // White
-        default: cout << "\033[37m"; break; // white
+    if (!Terminal::supports_vt())
+    {
+        // Console attributes apply immediately, so pending text must go out first
+        frame.flush();
+        Terminal::legacy_set_color(color);
+        return;
     }
-#endif
+    FrameScope scope(frame);
+    Terminal::set_color(frame.out(), color);
 }
 
 void Utility::reset_console_color()
 {
-#ifdef _WIN32
-    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
-    SetConsoleTextAttribute(hConsole, 7);
-#else
-    cout << "\033[0m";
-#endif
+    if (!Terminal::supports_vt())
+    {
+        frame.flush();
+        Terminal::legacy_set_color(LIGHT_GRAY);
+        return;
+    }
+    FrameScope scope(frame);
+    Terminal::reset_color(frame.out());
 }
 
-void Utility::print_line(int length = 50)
+void Utility::clear_screen()
 {
-    for (int i = 0; i < length; i++)
+    if (!Terminal::supports_vt())
     {
-        cout << "=";
+        frame.flush();
+        Terminal::legacy_clear_screen();
+        return;
     }
-    cout << endl;
+    FrameScope scope(frame);
+    Terminal::clear_screen(frame.out());
+}
+
+void Utility::print_line(int length = 50)
+{
+    FrameScope scope(frame);
+    out() << string(length, '=') << '\n';
 }
 
 void Utility::print_dashed_line(int length = 50)
 {
-    for (int i = 0; i < length; i++)
-    {
-        cout << "-";
-    }
-    cout << endl;
+    FrameScope scope(frame);
+    out() << string(length, '-') << '\n';
 }
 
 void Utility::print_header(const string &title)
 {
-    system("cls");
+    FrameScope scope(frame);
+    clear_screen();
     print_line(60);
-    cout << "| " << setw(56) << left << title << " |" << endl;
+    out() << "| " << setw(56) << left << title << " |" << '\n';
     print_line(60);
-    cout << endl;
+    out() << '\n';
 }
 
 void Utility::print_menu_box(const string &title, const vector<string> &options)
 {
-    system("cls");
+    FrameScope scope(frame);
+    clear_screen();
+    ostream &screen = out();
+    string border = "+" + string(58, '-') + "+\n";
 
     // Top border
-    cout << "+";
-    for (int i = 0; i < 58; i++)
-        cout << "-";
-    cout << "+" << endl;
+    screen << border;
 
     // Title
-    cout << "|" << setw(30 - title.length() / 2) << "" << title;
-    cout << setw(30 - title.length() / 2 - (title.length() % 2) - 2) << "" << "|" << endl;
+    screen << "|" << setw(30 - title.length() / 2) << "" << title;
+    screen << setw(30 - title.length() / 2 - (title.length() % 2) - 2) << "" << "|" << '\n';
 
     // Separator
-    cout << "+";
-    for (int i = 0; i < 58; i++)
-        cout << "-";
-    cout << "+" << endl;
+    screen << border;
 
     // Options
     for (size_t i = 0; i < options.size(); i++)
     {
-        cout << "| [" << (i + 1) << "] " << setw(51) << left << options[i] << "  |" << endl;
+        screen << "| [" << (i + 1) << "] " << setw(51) << left << options[i] << "  |" << '\n';
     }
 
     // Bottom border
-    cout << "+";
-    for (int i = 0; i < 58; i++)
-        cout << "-";
-    cout << "+" << endl;
+    screen << border;
 
-    cout << endl;
+    screen << '\n';
 }
 
 void Utility::print_success_message(const string &message)
 {
-    cout << endl;
+    FrameScope scope(frame);
+    out() << '\n';
     Utility::set_console_color(Utility::Colors::GREEN);
     print_dashed_line(40);
-    cout << "SUCCESS: " << message << endl;
+    out() << "SUCCESS: " << message << '\n';
     print_dashed_line(40);
     Utility::reset_console_color();
 }
 
 void Utility::print_error_message(const string &message)
 {
-    cout << endl;
+    FrameScope scope(frame);
+    out() << '\n';
     Utility::set_console_color(Utility::Colors::RED);
     print_dashed_line(40);
-    cout << "ERROR: " << message << endl;
+    out() << "ERROR: " << message << '\n';
     print_dashed_line(40);
     Utility::reset_console_color();
 }
 
 void Utility::print_info_box(const string &message)
 {
-    cout << endl;
-    cout << "+";
-    for (int i = 0; i < message.length() + 6; i++)
-        cout << "-";
-    cout << "+" << endl;
-    cout << "|   " << message << "   |" << endl;
-    cout << "+";
-    for (int i = 0; i < message.length() + 6; i++)
-        cout << "-";
-    cout << "+" << endl;
+    FrameScope scope(frame);
+    string border = "+" + string(message.length() + 6, '-') + "+\n";
+    out() << '\n'
+          << border
+          << "|   " << message << "   |" << '\n'
+          << border;
 }
 
 int Utility::take_integer_input(int min, int max, string prompt)
@@ -173,6 +169,17 @@ int Utility::take_integer_input(int min, int max, string prompt)
     return variable;
 }
 
+bool Utility::is_valid_phone(const string &phone)
+{
+    // 11 digits, starts with 03
+    return phone.length() == 11 && phone.compare(0, 2, "03") == 0 && all_of(phone.begin(), phone.end(), ::isdigit);
+}
+
+bool Utility::is_valid_age(int age)
+{
+    return age >= MIN_AGE && age <= MAX_AGE;
+}
+
 string Utility::take_phone_input()
 {
     string variable;
@@ -183,8 +190,7 @@ string Utility::take_phone_input()
         cout << "Enter 11 digit phone number (03XXXXXXXXX): ";
         cin >> variable;
 
-        // Check if the input is a valid phone number (11 digits, starts with 03)
-        if (variable.length() != 11 || variable.substr(0, 2) != "03" || !all_of(variable.begin(), variable.end(), ::isdigit))
+        if (!is_valid_phone(variable))
         {
             Utility::print_error_message("Invalid phone number.\nPlease enter an 11-digit number starting with 03.");
             cin.ignore(numeric_limits<streamsize>::max(), '\n'); // Clear any remaining input
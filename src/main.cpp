@@ -1,71 +1,77 @@
 #include <iostream>
 #include <vector>
 #include <stdlib.h>
-#include <conio.h>
 #include <string>
 
 #include "Utility.h"
+#include "Terminal.h"
 #include "Person.h"
 #include "Student.h"
 #include "Teacher.h"
 #include "Staff.h"
 #include "Database_handler.h"
+#include "RecordStore.h"
+#include "IdAllocator.h"
+#include "Snapshot.h"
+#include "Journal.h"
+#include "BatchRunner.h"
+#include "CsvPipeline.h"
+#include "Server.h"
+#include "Metrics.h"
+#include "MemoryAccounting.h"
+#include <fstream>
 #include <limits>
+#include <iomanip>
+#include <csignal>
+#include <stdexcept>
 
 using namespace std;
 
-Person **data = new Person *[100];
-int *ids = new int[100];
-int current_id = 0;
+RecordStore store;
+IdAllocator ids;
+Journal journal;
 
 int give_id()
 {
+    return ids.allocate();
+}
 
-    if (current_id <= 0)
+// Fold the journal into the base files once it grows large
+void compact_journal()
+{
+    if (save_snapshot(store, ids))
     {
-        current_id = 1000;
+        journal.reset();
     }
+}
 
-    // Find the next available ID that's not already in use
-    int next_id = current_id + 1;
-    bool id_exists = true;
-
-    while (id_exists)
+void journal_written()
+{
+    if (journal.needs_compaction())
     {
-        id_exists = false;
-        // Check if this ID already exists in data
-        for (int i = 0; i < 100; i++)
-        {
-            if (data[i] != nullptr && data[i]->getId() == next_id)
-            {
-                id_exists = true;
-                next_id++;
-                break;
-            }
-        }
+        compact_journal();
     }
+}
 
-    for (int i = 0; i < 100; i++)
+// On exit: a run that changed nothing leaves the files alone
+void compact_if_changed()
+{
+    if (journal.getEntries() > 0 || journal.needs_compaction())
     {
-        if (ids[i] == 0)
-        {
-            ids[i] = next_id;
-            current_id = next_id;
-            break;
-        }
+        compact_journal();
     }
-    current_id = next_id;
-    return current_id;
 }
 
-void add_person()
+// Exit teardown: the pools free every record in bulk instead of
+// deleting them one at a time
+void release_records()
 {
-    if (Person::getCount() >= 100)
-    {
-        Utility::print_error_message("Data is full, cannot save more Persons.");
-        return;
-    }
+    store.abandon();
+    Person::release_pools();
+}
 
+void add_person()
+{
     Person *person;
     int choice, id, age;
     string name, address, phone, subject, designation;
@@ -97,16 +103,37 @@ void add_person()
         person = new Staff();
     }
 
-    person->get_common_inputs();
-    person->setId(id);
-    person->get_specific_inputs();
+    try
+    {
+        person->get_common_inputs();
+        person->setId(id);
+        person->get_specific_inputs();
+    }
+    catch (const length_error &e)
+    {
+        // The string table had no room for the address or subject
+        Utility::print_error_message(string("Not saved: ") + e.what());
+        delete person;
+        ids.release(id);
+        Terminal::read_key();
+        return;
+    }
 
-    if (person->save(data))
+    // Timed from here, the prompts above are not part of the operation
+    uint64_t start = Metrics::now();
+    bool saved = person->save(store);
+    if (saved)
+    {
+        journal.log_add(person);
+        journal_written();
+    }
+    Metrics::record(TIMER_ADD, Metrics::now() - start);
+    if (saved)
     {
         Utility::print_success_message(person->printType() + " saved successfully.");
     }
     Utility::print_success_message("ID assigned: " + to_string(id));
-    getch();
+    Terminal::read_key();
 }
 
 void get_person_data()
@@ -115,18 +142,22 @@ void get_person_data()
     int choice;
     Utility::print_header("GET PERSON DATA");
     int id;
-    id = Utility::take_integer_input(1, 10000, "ID to find");
+    id = Utility::take_integer_input(1, numeric_limits<int>::max(), "ID to find");
 
-    int index = Person::get_person_by_id(id, data);
-    if (index == -1)
+    // Only the lookup is timed, printing the record is console output
+    uint64_t start = Metrics::now();
+    person = store.at(store.find(id));
+    Metrics::record(TIMER_LOOKUP, Metrics::now() - start);
+    if (person == nullptr)
     {
+        Metrics::count(COUNTER_LOOKUP_MISSES);
         Utility::print_error_message("No Person found with ID: " + to_string(id));
-        getch();
+        Terminal::read_key();
         return;
     }
-    person = data[index];
+    cout << person->printType() << endl;
     person->printDetails();
-    getch();
+    Terminal::read_key();
 }
 
 void modify_person()
@@ -135,29 +166,118 @@ void modify_person()
     int id, index = 0;
 
     Utility::print_header("MODIFY PERSON DATA");
-    id = Utility::take_integer_input(1, 10000, "ID to modify");
+    id = Utility::take_integer_input(1, numeric_limits<int>::max(), "ID to modify");
 
-    index = Person::get_person_by_id(id, data);
+    index = Person::get_person_by_id(id, store);
     if (index == -1)
     {
         Utility::print_error_message("No Person found with ID: " + to_string(id));
-        getch();
+        Terminal::read_key();
         return;
     }
 
-    person = data[index];
+    // Edit a copy, so a change that cannot be stored leaves the record as it was
+    person = store.at(index)->clone();
     Utility::print_dashed_line(20);
     cout << "Modifying " << person->printType() << " with ID: "
          << id << endl;
     Utility::print_dashed_line(20);
-    person->get_common_inputs();
-    person->get_specific_inputs();
+    try
+    {
+        person->get_common_inputs();
+        person->get_specific_inputs();
+    }
+    catch (const length_error &e)
+    {
+        Utility::print_error_message(string("Not saved: ") + e.what());
+        delete person;
+        Terminal::read_key();
+        return;
+    }
 
-    if (person->save(data, index))
+    uint64_t start = Metrics::now();
+    bool saved = person->save(store, index);
+    if (saved)
+    {
+        journal.log_modify(person);
+        journal_written();
+    }
+    Metrics::record(TIMER_MODIFY, Metrics::now() - start);
+    if (saved)
     {
         Utility::print_success_message(person->printType() + " modified successfully.");
     }
-    getch();
+    Terminal::read_key();
+}
+
+void print_search_results(const vector<int> &slots)
+{
+    const size_t SHOWN = 50;
+    if (slots.empty())
+    {
+        Utility::print_error_message("No matching records found.");
+        return;
+    }
+    cout << left << setw(8) << "ID" << setw(10) << "Type" << setw(30) << "Name" << "Age" << endl;
+    Utility::print_dashed_line(25);
+    for (size_t i = 0; i < slots.size() && i < SHOWN; i++)
+    {
+        Person *person = store.at(slots[i]);
+        cout << left << setw(8) << person->getId() << setw(10) << person->printType()
+             << setw(30) << person->getName() << person->getAge() << endl;
+    }
+    cout << right;
+    if (slots.size() > SHOWN)
+    {
+        cout << "... and " << slots.size() - SHOWN << " more" << endl;
+    }
+    Utility::print_success_message(to_string(slots.size()) + " record(s) found.");
+}
+
+void search_person()
+{
+    Utility::print_header("SEARCH PERSON DATA");
+    vector<string> options = {
+        "By Name (closest matches)",
+        "By Name (starts with)",
+        "Teachers by Subject",
+        "Staff by Designation",
+        "By Age Range",
+        "Back to Main Menu"};
+    Utility::print_menu_box("SEARCH", options);
+
+    int choice = Utility::take_integer_input(1, 6, "Select an option");
+    vector<int> slots;
+    if (choice == 6)
+        return;
+
+    if (choice == 1)
+    {
+        // Ranked, so typos and partial names still find the person
+        slots = store.find_by_name(Utility::take_string_input("Name (full or partial)"));
+    }
+    else if (choice == 2)
+    {
+        slots = store.find_by_name_prefix(Utility::take_string_input("Name starts with"));
+    }
+    else if (choice == 3)
+    {
+        slots = store.find_by_subject(Utility::take_string_input("Subject"));
+    }
+    else if (choice == 4)
+    {
+        slots = store.find_by_designation(Utility::take_string_input("Designation"));
+    }
+    else
+    {
+        int min_age = Utility::take_integer_input(Utility::MIN_AGE, Utility::MAX_AGE, "From age");
+        int max_age = Utility::take_integer_input(min_age, Utility::MAX_AGE, "To age");
+        int type = Utility::take_integer_input(1, 4, "Type (1 Student, 2 Teacher, 3 Staff, 4 Any)");
+        PersonKind kind = type == 4 ? KIND_COUNT : (PersonKind)(type - 1);
+        slots = store.find_by_age(min_age, max_age, kind);
+    }
+    print_search_results(slots);
+    Terminal::read_key();
 }
 
 void display_system_stats()
@@ -166,19 +286,81 @@ void display_system_stats()
 
     cout << "Database Status:" << endl;
     Utility::print_dashed_line(20);
-    cout << "Total Records: " << Person::getCount() << "/100" << endl;
-    cout << "Available Slots: " << (100 - Person::getCount()) << endl;
-    cout << "Memory Usage: " << (Person::getCount() * 100.0 / 100) << "%" << endl;
+    cout << "Total Records: " << store.size() << endl;
+    cout << "Free Slots: " << (store.slot_count() - store.size()) << endl;
+
+    // Counts and ages come from the store's columns, no record is touched
+    int counts[KIND_COUNT];
+    store.count_by_kind(counts);
+    AgeStats ages = store.age_stats();
 
     cout << "\nRecord Distribution:" << endl;
     Utility::print_dashed_line(25);
-    cout << "Students: " << Student::getCount() << endl;
-    cout << "Teachers: " << Teacher::getCount() << endl;
-    cout << "Staff: " << Staff::getCount() << endl;
-    cout << "Total People: " << Person::getCount() << endl;
+    cout << "Students: " << counts[KIND_STUDENT] << endl;
+    cout << "Teachers: " << counts[KIND_TEACHER] << endl;
+    cout << "Staff: " << counts[KIND_STAFF] << endl;
+    cout << "Total People: " << store.size() << endl;
+    if (ages.count > 0)
+    {
+        cout << "Average Age: " << ages.average << " (" << ages.min_age << "-" << ages.max_age << ")" << endl;
+    }
+
+    MemoryReport memory = MemoryAccounting::measure(store);
+    auto memory_line = [](const string &label, size_t bytes, const string &note) {
+        cout << left << setw(30) << label << right << setw(10) << MemoryAccounting::format_bytes(bytes) << note << endl;
+    };
+    auto allocations = [&memory](MemorySubsystem subsystem) {
+        return "  (" + to_string(memory.allocations[subsystem]) + " allocations)";
+    };
+    cout << "\nMemory Usage:" << endl;
+    Utility::print_dashed_line(25);
+    memory_line("Person objects", memory.record_bytes, "");
+    memory_line("Record pools", memory.tracked[MEM_RECORDS], "  (live and free blocks)");
+    memory_line("Name/phone text", memory.string_bytes, "");
+    memory_line("Interned text", memory.interned_bytes, "  (addresses, subjects, designations)");
+    memory_line("Slots, columns, id index", memory.tracked[MEM_STORE], allocations(MEM_STORE));
+    memory_line("Search indexes", memory.tracked[MEM_INDEXES], allocations(MEM_INDEXES));
+    memory_line("Record versions", memory.tracked[MEM_VERSIONS], allocations(MEM_VERSIONS));
+    memory_line("Total accounted", memory.accounted(), "");
+    if (memory.rss_bytes > 0)
+        memory_line("Process RSS", memory.rss_bytes, "");
+    else
+        cout << left << setw(30) << "Process RSS" << right << setw(10) << "n/a" << endl;
+
+    MetricsSnapshot metrics = Metrics::snapshot();
+    cout << "\nOperation Timings (microseconds):" << endl;
+    Utility::print_dashed_line(25);
+    cout << left << setw(10) << "Operation" << right << setw(9) << "Count" << setw(11) << "Avg" << setw(11) << "p50"
+         << setw(11) << "p99" << setw(11) << "Max" << endl;
+    cout << fixed << setprecision(1);
+    for (int t = 0; t < TIMER_COUNT; t++)
+    {
+        const TimerStats &stats = metrics.timers[t];
+        cout << left << setw(10) << Metrics::timer_name((MetricTimer)t) << right << setw(9) << stats.count
+             << setw(11) << stats.mean_us() << setw(11) << stats.percentile_us(0.5) << setw(11)
+             << stats.percentile_us(0.99) << setw(11) << stats.max_ns / 1000.0 << endl;
+    }
+    cout.unsetf(ios::floatfield);
+    cout << setprecision(6);
+    cout << "\nCounters:" << endl;
+    Utility::print_dashed_line(25);
+    for (int c = 0; c < COUNTER_COUNT; c++)
+    {
+        cout << Metrics::counter_name((MetricCounter)c) << ": " << metrics.counters[c] << endl;
+    }
 
-    Utility::print_success_message("Press any key to continue...");
-    getch();
+    cout << "\nJ: save metrics as JSON, P: save as Prometheus text, any other key: back" << endl;
+    int key = Terminal::read_key();
+    if (key == 'j' || key == 'J' || key == 'p' || key == 'P')
+    {
+        ensureDataDirectory();
+        string path = key == 'j' || key == 'J' ? "../data/metrics.json" : "../data/metrics.prom";
+        if (Metrics::write_file(path))
+            Utility::print_success_message("Metrics written to " + path);
+        else
+            Utility::print_error_message("Cannot write " + path);
+        Terminal::read_key();
+    }
 }
 
 void delete_person()
@@ -187,17 +369,17 @@ void delete_person()
     int id, index = -1;
 
     Utility::print_header("DELETE PERSON DATA");
-    id = Utility::take_integer_input(1, 10000, "ID to delete");
+    id = Utility::take_integer_input(1, numeric_limits<int>::max(), "ID to delete");
 
-    index = Person::get_person_by_id(id, data);
+    index = Person::get_person_by_id(id, store);
     if (index == -1)
     {
         Utility::print_error_message("No Person found with ID: " + to_string(id));
-        getch();
+        Terminal::read_key();
         return;
     }
 
-    person = data[index];
+    person = store.at(index);
     person->printDetails();
     Utility::print_success_message("FOUND PERSON WITH ID: " + to_string(id));
 
@@ -208,16 +390,21 @@ void delete_person()
     if (confirm != 'y' && confirm != 'Y')
     {
         Utility::print_success_message("Deletion cancelled by user!");
-        getch();
+        Terminal::read_key();
         return;
     }
 
     string person_type = person->printType();
-    delete data[index];
-    data[index] = nullptr;
+    {
+        ScopedTimer timer(TIMER_DELETE);
+        store.erase(index);
+        ids.release(id);
+        journal.log_delete(id);
+        journal_written();
+    }
 
     Utility::print_success_message(person_type + " with ID " + to_string(id) + " deleted successfully!");
-    getch();
+    Terminal::read_key();
 }
 
 void main_menu()
@@ -230,12 +417,20 @@ void main_menu()
             "View Data",
             "Modify Data",
             "Delete Data",
+            "Search Data",
             "System Statistics",
             "Exit Program"};
 
+        // Menu and prompt go out as one write
+        Utility::begin_frame();
         Utility::print_menu_box("SCHOOL MANAGEMENT SYSTEM", options);
-        cout << "Enter your choice (1-6): ";
-        cin >> choice;
+        Utility::out() << "Enter your choice (1-7): ";
+        Utility::end_frame();
+        if (!(cin >> choice))
+        {
+            // Input closed, every change is already in the journal
+            break;
+        }
 
         switch (choice)
         {
@@ -252,36 +447,318 @@ void main_menu()
             delete_person();
             break;
         case '5':
-            display_system_stats();
+            search_person();
             break;
         case '6':
+            display_system_stats();
+            break;
+        case '7':
             Utility::print_header("PROGRAM EXIT");
             cout << "Thank you for using School Management System!" << endl;
             Utility::print_success_message("Program terminated successfully!");
-            save_person(data);
-            getch();
+            compact_if_changed();
+            Terminal::read_key();
             break;
         default:
-            Utility::print_error_message("Invalid choice! Please select 1-6.");
+            Utility::print_error_message("Invalid choice! Please select 1-7.");
             cout << "\nPress any key to continue...";
-            getch();
+            Terminal::read_key();
         }
-    } while (choice != '6');
+    } while (choice != '7');
 }
 
-int main()
+// Snapshot or text files, then the journal. Returns false, leaving every
+// file alone, when only the text files could be loaded but the snapshot
+// may hold changes they lack, when the text files hold more distinct
+// values than the string table can take, or when a committed journal
+// entry cannot be applied (an exit would compact it away).
+// trust_snapshot reads the snapshot even if a text file looks newer
+// (sms --compact).
+bool load_database(bool trust_snapshot = false)
 {
-    // getch();
-    system("cls");
+    ScopedTimer timer(TIMER_LOAD);
+    // Base files and journal replay all go in before the indexes are built
+    store.begin_bulk_load();
+    // Prefer the binary snapshot, fall back to importing the text files
+    bool stale = !trust_snapshot && !snapshot_is_current();
+    if (stale || !read_snapshot(store, ids))
+    {
+        store.clear();
+        ids.reset();
+        if (snapshot_ahead_of_text())
+        {
+            store.end_bulk_load();
+            cerr << "Error: " << SNAPSHOT_PATH << " holds changes that are not in the text files, and it "
+                 << (stale ? "is older than one of them." : "cannot be read.") << endl;
+            if (stale)
+                cerr << "Run 'sms --compact' to rewrite the text files from it, ";
+            else
+                cerr << "Restore it from a backup, ";
+            cerr << "or delete it to load the text files as they are." << endl;
+            return false;
+        }
+        try
+        {
+            read_person(store, ids);
+        }
+        catch (const length_error &e)
+        {
+            store.end_bulk_load();
+            cerr << "Error: the text files cannot be loaded: " << e.what() << "." << endl;
+            return false;
+        }
+    }
+    // Re-apply changes made after the base files were last written
+    bool replayed = journal.replay(store, ids);
+    store.end_bulk_load();
+    if (!replayed)
+    {
+        cerr << "Error: " << JOURNAL_PATH << " holds committed changes that cannot be applied (see above). "
+             << "Fix or remove those lines, then start again." << endl;
+        release_records();
+        return false;
+    }
+    journal.open();
+    Metrics::count(COUNTER_RECORDS_LOADED, store.size());
+    return true;
+}
 
-    data = read_person(ids, current_id);
-    main_menu();
+// sms --batch <file|-> [--commit-every N]
+int run_batch(int argc, char *argv[])
+{
+    string path = "-";
+    int commit_every = 0;
+    for (int i = 2; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "--commit-every" && i + 1 < argc)
+        {
+            commit_every = atoi(argv[++i]);
+        }
+        else
+        {
+            path = arg;
+        }
+    }
+
+    ifstream file;
+    if (path != "-")
+    {
+        file.open(path.c_str());
+        if (!file.is_open())
+        {
+            cerr << "Cannot open batch file: " << path << endl;
+            return 2;
+        }
+    }
+
+    if (!load_database())
+    {
+        return 2;
+    }
+    BatchRunner runner(store, ids, journal, cout, cerr, commit_every);
+    int failed = runner.run(path == "-" ? cin : file);
+
+    // One commit of the whole run into the snapshot
+    compact_if_changed();
+    journal.close();
+    release_records();
+
+    cerr << runner.getSucceeded() << " command(s) succeeded, " << failed << " failed." << endl;
+    return failed == 0 ? 0 : 1;
+}
+
+// sms --import <file.csv|-> [--type T] [--batch-size N]
+// sms --export <file.csv|-> [--type T]
+int run_csv(int argc, char *argv[])
+{
+    bool importing = string(argv[1]) == "--import";
+    string path = "-";
+    string type;
+    int batch_size = 1000;
+    for (int i = 2; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "--type" && i + 1 < argc)
+        {
+            type = argv[++i];
+        }
+        else if (arg == "--batch-size" && i + 1 < argc)
+        {
+            batch_size = atoi(argv[++i]);
+        }
+        else
+        {
+            path = arg;
+        }
+    }
 
-    for (int i = 0; i < 100 && data[i] != nullptr; i++)
+    PersonKind kind = KIND_COUNT;
+    if (!type.empty() && !Person::kind_from_name(type, kind))
     {
-        delete data[i];
+        cerr << "Unknown type: " << type << endl;
+        return 2;
     }
-    delete[] data;
 
+    if (!load_database())
+    {
+        return 2;
+    }
+    int status = 0;
+    if (importing)
+    {
+        ifstream file;
+        if (path != "-")
+        {
+            file.open(path.c_str());
+            if (!file.is_open())
+            {
+                cerr << "Cannot open CSV file: " << path << endl;
+                journal.close();
+                release_records();
+                return 2;
+            }
+        }
+        CsvImportResult result;
+        {
+            CsvImporter importer(store, ids, journal, cerr, batch_size);
+            importer.setDefaultType(type);
+            result = importer.run(path == "-" ? cin : file);
+        }
+        compact_if_changed();
+        cerr << result.imported << " of " << result.rows << " row(s) imported, " << result.failed << " failed." << endl;
+        status = result.aborted || result.failed > 0 ? 1 : 0;
+    }
+    else
+    {
+        ofstream file;
+        if (path != "-")
+        {
+            file.open(path.c_str(), ios::trunc);
+            if (!file.is_open())
+            {
+                cerr << "Cannot open CSV file: " << path << endl;
+                journal.close();
+                release_records();
+                return 2;
+            }
+        }
+        long long rows = export_csv(store, path == "-" ? cout : file, kind);
+        cerr << rows << " row(s) exported." << endl;
+    }
+
+    journal.close();
+    release_records();
+    return status;
+}
+
+Server *active_server = nullptr;
+
+void stop_server(int)
+{
+    if (active_server != nullptr)
+    {
+        active_server->stop();
+    }
+}
+
+// sms --serve [socket]
+int run_serve(int argc, char *argv[])
+{
+    string path = argc > 2 ? argv[2] : SERVER_SOCKET_PATH;
+
+    if (!load_database())
+    {
+        return 2;
+    }
+    Server server(store, ids, journal, path);
+    if (!server.start())
+    {
+        journal.close();
+        release_records();
+        return 2;
+    }
+    active_server = &server;
+    signal(SIGINT, stop_server);
+    signal(SIGTERM, stop_server);
+    cerr << "Serving " << store.size() << " records on " << path << " (Ctrl+C to stop)" << endl;
+    server.run();
+    active_server = nullptr;
+
+    // Same shutdown as leaving the menu
+    compact_if_changed();
+    journal.close();
+    release_records();
+    cerr << "Server stopped." << endl;
     return 0;
+}
+
+// sms --compact
+// Rewrites the text files and the snapshot from the current roster and
+// empties the journal. Exits only touch the snapshot, this is the step
+// that brings the text files up to date. The snapshot is read even when
+// a text file is newer, which is how a refused start is recovered.
+int run_compact()
+{
+    if (!load_database(true))
+    {
+        return 2;
+    }
+    // Text files first, so the snapshot is never older than them
+    save_person(store);
+    bool compacted = save_snapshot(store, ids, SNAPSHOT_PATH, true) && journal.reset();
+    journal.close();
+    cerr << store.size() << " record(s) written." << endl;
+    release_records();
+    return compacted ? 0 : 1;
+}
+
+int run_menu()
+{
+    // Terminal::read_key();
+    Utility::clear_screen();
+
+    if (!load_database())
+    {
+        return 2;
+    }
+    main_menu();
+
+    journal.close();
+    release_records();
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    int status;
+    if (argc > 1 && (string(argv[1]) == "--import" || string(argv[1]) == "--export"))
+    {
+        status = run_csv(argc, argv);
+    }
+    else if (argc > 1 && string(argv[1]) == "--batch")
+    {
+        status = run_batch(argc, argv);
+    }
+    else if (argc > 1 && string(argv[1]) == "--serve")
+    {
+        status = run_serve(argc, argv);
+    }
+    else if (argc > 1 && string(argv[1]) == "--compact")
+    {
+        status = run_compact();
+    }
+    else
+    {
+        status = run_menu();
+    }
+
+    // SMS_METRICS_FILE=path dumps the run's metrics on the way out
+    const char *metrics_file = getenv("SMS_METRICS_FILE");
+    if (metrics_file != nullptr && *metrics_file != '\0' && !Metrics::write_file(metrics_file))
+    {
+        cerr << "Cannot write metrics to " << metrics_file << endl;
+    }
+    return status;
 }
\ No newline at end of file
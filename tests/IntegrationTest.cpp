@@ -3,12 +3,19 @@
 #include "../include/Teacher.h"
 #include "../include/Staff.h"
 #include "../include/Utility.h"
+#include "../include/Terminal.h"
 #include "../include/Database_handler.h"
+#include "../include/RecordStore.h"
+#include "../include/Snapshot.h"
+#include "../include/Journal.h"
+#include "../include/BatchRunner.h"
+#include "../include/CsvPipeline.h"
+#include "../include/Server.h"
+#include <sstream>
 #include <iostream>
 #include <string>
 #include <vector>
 #include <fstream>  // For file operations
-#include <conio.h>  // For getch()
 #include <sys/stat.h>  // For directory checking
 
 #ifdef _WIN32
@@ -17,6 +24,11 @@
 #else
 #include <sys/stat.h>
 #include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <cstring>
+#include <thread>
+#include <atomic>
 #endif
 
 using namespace std;
@@ -31,7 +43,7 @@ int testsFailed = 0;
 void pauseIfRequested() {
     if (pauseAfterEachTest) {
         cout << "\nPress any key to continue to next test...";
-        getch();
+        Terminal::read_key();
         cout << "\n" << endl;
     }
 }
@@ -78,7 +90,7 @@ void printStep(int stepNum, const string& action, bool result = true) {
     // Pause after each step if user requested it
     if (pauseAfterEachTest) {
         cout << "Press any key to continue to next step...";
-        getch();
+        Terminal::read_key();
         cout << endl;
     }
 }
@@ -93,7 +105,7 @@ void printSubAction(const string& action, const string& result = "") {
     // Pause after each sub-action if user requested it
     if (pauseAfterEachTest) {
         cout << "    Press any key to continue...";
-        getch();
+        Terminal::read_key();
         cout << endl;
     }
 }
@@ -299,25 +311,26 @@ bool testDataFileSystemIntegration() {
     printStep(3, "Testing database handler integration");
     cout << "\nTesting database functionality:" << endl;
     try {
-        // Create test data - Use full 100-element array for compatibility with save_person
-        Person** testData = new Person*[100];
-        for (int i = 0; i < 100; i++) testData[i] = nullptr;
+        // Create test data in a record store
+        RecordStore testData;
         
         // Add test persons with unified ID system
-        testData[0] = new Student();
-        testData[0]->setName("Test Student");
-        testData[0]->setAge(20);
-        testData[0]->setPhone("555-0123");
-        testData[0]->setAddress("123 Test St");
-        testData[0]->setId(9999);  // Unified ID system
+        Person* student = new Student();
+        student->setName("Test Student");
+        student->setAge(20);
+        student->setPhone("555-0123");
+        student->setAddress("123 Test St");
+        student->setId(9999);  // Unified ID system
+        student->save(testData);
         
-        testData[1] = new Teacher();
-        testData[1]->setName("Test Teacher");
-        testData[1]->setAge(35);
-        testData[1]->setPhone("555-0124");
-        testData[1]->setAddress("124 Test St");
-        testData[1]->setId(8888);  // Unified ID system
-        testData[1]->setSubject("Test Subject");
+        Person* teacher = new Teacher();
+        teacher->setName("Test Teacher");
+        teacher->setAge(35);
+        teacher->setPhone("555-0124");
+        teacher->setAddress("124 Test St");
+        teacher->setId(8888);  // Unified ID system
+        teacher->setSubject("Test Subject");
+        teacher->save(testData);
         
         printSubAction("Test data prepared", "SUCCESS");
         
@@ -328,22 +341,122 @@ bool testDataFileSystemIntegration() {
         
         // Test read operation with updated database handler signature
         printSubAction("Attempting to read data", "EXECUTING");
-        int ids[100] = {0};
-        int current_id = 0;
-        Person** loadedData = read_person(ids, current_id);
-        printSubAction("Read operation", loadedData ? "COMPLETED" : "RETURNED NULL");
+        RecordStore loadedData;
+        IdAllocator ids;
+        read_person(loadedData, ids);
+        bool roundTrip = (loadedData.size() == 2 && loadedData.find(9999) != -1 &&
+                          loadedData.find(8888) != -1 && ids.getHighWater() == 9999);
+        printSubAction("Read operation", roundTrip ? "COMPLETED" : "DATA MISMATCH");
+        allPassed &= roundTrip;
         
-        // Cleanup
-        delete testData[0];
-        delete testData[1];
-        delete[] testData;
+        // Test binary snapshot round trip
+        printSubAction("Attempting to save binary snapshot", "EXECUTING");
+        string snapshotPath = "../data/test_roster.bin";
+        // Released IDs travel with the snapshot, one still in use is dropped on load
+        IdAllocator savedIds = ids;
+        savedIds.release(5000);
+        savedIds.release(8888);
+        savedIds.release(4000);
+        bool snapshotSaved = save_snapshot(testData, savedIds, snapshotPath);
+        RecordStore snapshotData;
+        IdAllocator snapshotIds;
+        bool snapshotLoaded = snapshotSaved && read_snapshot(snapshotData, snapshotIds, snapshotPath);
+        Person* loadedTeacher = snapshotData.at(snapshotData.find(8888));
+        bool snapshotMatch = snapshotLoaded && snapshotData.size() == 2 && loadedTeacher != nullptr &&
+                             loadedTeacher->printType() == "Teacher" &&
+                             static_cast<Teacher*>(loadedTeacher)->getSubject() == "Test Subject" &&
+                             loadedTeacher->getAddress() == "124 Test St" &&
+                             snapshotIds.getHighWater() == 9999 && snapshotIds.free_count() == 2 &&
+                             snapshotIds.allocate() == 4000 && snapshotIds.allocate() == 5000;
+        printSubAction("Snapshot round trip", snapshotMatch ? "COMPLETED" : "DATA MISMATCH");
+        allPassed &= snapshotMatch;
         
-        if (loadedData) {
-            for (int i = 0; i < 100 && loadedData[i] != nullptr; i++) {
-                delete loadedData[i];
-            }
-            delete[] loadedData;
+        // Only a snapshot written with the text files lets a load fall back to them
+        bool aheadUnflagged = snapshot_ahead_of_text(snapshotPath);
+        bool flaggedSaved = save_snapshot(testData, savedIds, snapshotPath, true);
+        bool aheadFlagged = snapshot_ahead_of_text(snapshotPath);
+        remove(snapshotPath.c_str());
+        bool aheadTest = aheadUnflagged && flaggedSaved && !aheadFlagged && !snapshot_ahead_of_text(snapshotPath);
+        printSubAction("Snapshot ahead of the text files", aheadTest ? "COMPLETED" : "WRONG ANSWER");
+        allPassed &= aheadTest;
+        
+        // Test journal replay, including a torn last entry
+        printSubAction("Attempting journal append and replay", "EXECUTING");
+        string journalPath = "../data/test_journal.log";
+        remove(journalPath.c_str());
+        {
+            Journal journal(journalPath);
+            journal.log_add(student);
+            journal.log_add(teacher);
+            teacher->setAddress("200 Moved St");
+            journal.log_modify(teacher);
+            journal.log_delete(9999);
+        }
+        {
+            ofstream torn(journalPath.c_str(), ios::app);
+            torn << "A`Student`7000`20`Half Writ";
+        }
+        RecordStore journalData;
+        IdAllocator journalIds;
+        Journal replayJournal(journalPath);
+        int applied = 0;
+        bool replayed = replayJournal.replay(journalData, journalIds, &applied);
+        Person* movedTeacher = journalData.at(journalData.find(8888));
+        bool journalMatch = replayed && applied == 4 && journalData.size() == 1 && journalData.find(9999) == -1 &&
+                            journalData.find(7000) == -1 && movedTeacher != nullptr &&
+                            movedTeacher->getAddress() == "200 Moved St";
+        printSubAction("Journal replay", journalMatch ? "COMPLETED" : "DATA MISMATCH");
+        allPassed &= journalMatch;
+        replayJournal.reset();
+        
+        // An intact entry that cannot be applied fails the replay
+        {
+            Journal journal(journalPath);
+            Student malformed;
+            malformed.setName("Ann`Extra");
+            malformed.setId(7001);
+            journal.log_add(&malformed);
+            journal.log_delete(8888);
         }
+        RecordStore rejectData;
+        IdAllocator rejectIds;
+        int rejectApplied = 0;
+        bool rejectReplayed = replayJournal.replay(rejectData, rejectIds, &rejectApplied);
+        bool rejectTest = !rejectReplayed && rejectApplied == 1 && rejectData.find(7001) == -1;
+        printSubAction("Committed but malformed entry reported", rejectTest ? "COMPLETED" : "NOT REPORTED");
+        allPassed &= rejectTest;
+        replayJournal.reset();
+        remove(journalPath.c_str());
+        
+        // Test parallel load of a roster large enough to be split into chunks
+        printSubAction("Attempting parallel load of 40000 records", "EXECUTING");
+        RecordStore largeData;
+        for (int i = 0; i < 40000; i++) {
+            Person* person = (i % 3 == 0) ? (Person*)new Teacher() : (Person*)new Student();
+            person->setName("Bulk Person " + to_string(i));
+            person->setAge(18 + i % 30);
+            person->setPhone("03001234567");
+            person->setAddress("House " + to_string(i) + ", Block B");
+            person->setId(100000 + i);
+            person->setSubject("Math");
+            person->save(largeData);
+        }
+        save_person(largeData);
+        RecordStore parallelData;
+        IdAllocator parallelIds;
+        read_person(parallelData, parallelIds);
+        // Sequential order is every student in file order, then every teacher
+        vector<int> expectedOrder;
+        for (int i = 0; i < 40000; i++) if (i % 3 != 0) expectedOrder.push_back(100000 + i);
+        for (int i = 0; i < 40000; i++) if (i % 3 == 0) expectedOrder.push_back(100000 + i);
+        vector<int> loadedOrder;
+        for (Person* p : parallelData) loadedOrder.push_back(p->getId());
+        bool parallelMatch = (loadedOrder == expectedOrder && parallelIds.getHighWater() == 139999);
+        printSubAction("Parallel load order and max ID", parallelMatch ? "MATCHES SEQUENTIAL" : "MISMATCH");
+        allPassed &= parallelMatch;
+        save_person(testData);  // Leave the small test roster behind
+        
+        // Cleanup is handled by the record stores
         
     } catch (...) {
         printSubAction("Database operations", "EXCEPTION OCCURRED");
@@ -481,6 +594,275 @@ bool testStressAndPerformance() {
     return allPassed;
 }
 
+bool testBatchMode() {
+    printTestHeader("Batch Mode");
+    printTestDescription("Run scripted add/modify/delete/get commands without any menus or pauses");
+    
+    bool allPassed = true;
+    string journalPath = "../data/test_batch_journal.log";
+    remove(journalPath.c_str());
+    
+    printStep(1, "Running a batch script");
+    RecordStore store;
+    IdAllocator ids;
+    Journal journal(journalPath);
+    ostringstream output, errors;
+    istringstream script(
+        "# intake\n"
+        "add`Student`Ali Khan`20`03001234567`Street 1\n"
+        "add`Teacher`Bob`30`03001234568`Street 2`Math\n"
+        "add`Student`Too Young`12`03001234567`Street 3\n"
+        "add`Staff`Cara`41`0300123`Street 4`Clerk\n"
+        "add`Teacher`Ann`30`03001234567`Lahore`Math`x\n"
+        "modify`1002```03009999999`\n"
+        "modify`1002`````Math`x\n"
+        "delete`1001\n"
+        "get`1002\n");
+    BatchRunner runner(store, ids, journal, output, errors, 100);
+    int failed = runner.run(script);
+    printSubAction("Commands succeeded", to_string(runner.getSucceeded()));
+    printSubAction("Commands failed", to_string(failed));
+    
+    printStep(2, "Verifying results");
+    bool countTest = (runner.getSucceeded() == 5 && failed == 4 && store.size() == 1);
+    printSubAction("Invalid age, phone and backticks in fields rejected", countTest ? "YES" : "NO");
+    allPassed &= countTest;
+    bool getTest = (output.str().find("1002`Teacher`Bob`30`03009999999`Street 2`Math") != string::npos);
+    printSubAction("Modified teacher returned by get", getTest ? "YES" : "NO");
+    allPassed &= getTest;
+    
+    printStep(3, "Replaying the batch journal");
+    journal.close();
+    RecordStore replayed;
+    IdAllocator replayedIds;
+    Journal replayJournal(journalPath);
+    replayJournal.replay(replayed, replayedIds);
+    bool replayTest = (replayed.size() == 1 && replayed.find(1002) != -1);
+    printSubAction("Journal reproduces the batch", replayTest ? "YES" : "NO");
+    allPassed &= replayTest;
+    remove(journalPath.c_str());
+    
+    printTestResult("Batch Mode", allPassed, "Scripted operations applied without UI");
+    return allPassed;
+}
+
+bool testCsvPipeline() {
+    printTestHeader("CSV Import/Export");
+    printTestDescription("Stream a registrar CSV into the store in batches and export it back out");
+    
+    bool allPassed = true;
+    string journalPath = "../data/test_csv_journal.log";
+    remove(journalPath.c_str());
+    
+    printStep(1, "Importing a CSV with quoted fields and bad rows");
+    RecordStore store;
+    IdAllocator ids;
+    Journal journal(journalPath);
+    ostringstream errors;
+    istringstream csv(
+        "Name,Age,Phone,Address,Type,Subject,Designation,ID\r\n"
+        "\"Khan, Ali\",20,03001234567,\"House 5, Street 1\",Student,,,\r\n"
+        "Bob,30,03001234568,\"Lane \"\"B\"\"\",Teacher,Math,,2000\r\n"
+        "Cara,41,03001234569,Street 4,Staff,,Clerk,\r\n"
+        "Too Young,12,03001234567,Street 3,Student,,,\r\n"
+        "Dup,25,03001234567,Street 6,Student,,,2000\r\n"
+        "Nobody,25,03001234567,Street 7,Janitor,,,\r\n");
+    CsvImportResult result;
+    {
+        CsvImporter importer(store, ids, journal, errors, 2);
+        result = importer.run(csv);
+    }
+    printSubAction("Rows imported", to_string(result.imported));
+    printSubAction("Rows failed", to_string(result.failed));
+    bool countTest = (result.rows == 6 && result.imported == 3 && result.failed == 3 && store.size() == 3);
+    printSubAction("Invalid age, duplicate ID and unknown type rejected", countTest ? "YES" : "NO");
+    allPassed &= countTest;
+    bool errorTest = (errors.str().find("row 4:") != string::npos && errors.str().find("row 5:") != string::npos);
+    printSubAction("Errors reported with row numbers", errorTest ? "YES" : "NO");
+    allPassed &= errorTest;
+    int teacherIndex = store.find(2000);
+    bool quoteTest = (teacherIndex != -1 && store.at(teacherIndex)->getAddress() == "Lane \"B\"" &&
+                      store.find(1001) != -1 && store.at(store.find(1001))->getName() == "Khan, Ali");
+    printSubAction("Quoted fields and explicit IDs kept", quoteTest ? "YES" : "NO");
+    allPassed &= quoteTest;
+    
+    printStep(2, "Exporting and re-importing");
+    ostringstream exported;
+    long long rows = export_csv(store, exported);
+    RecordStore copy;
+    IdAllocator copyIds;
+    Journal copyJournal("../data/test_csv_copy_journal.log");
+    istringstream reimport(exported.str());
+    ostringstream copyErrors;
+    CsvImportResult copyResult = CsvImporter(copy, copyIds, copyJournal, copyErrors).run(reimport);
+    copyJournal.close();
+    remove("../data/test_csv_copy_journal.log");
+    bool roundTrip = (rows == 3 && copyResult.imported == 3 && copy.find(2000) != -1 &&
+                      copy.at(copy.find(2000))->getAddress() == "Lane \"B\"");
+    printSubAction("Round trip preserves records", roundTrip ? "YES" : "NO");
+    allPassed &= roundTrip;
+    
+    printStep(3, "Replaying the import journal");
+    journal.close();
+    RecordStore replayed;
+    IdAllocator replayedIds;
+    Journal replayJournal(journalPath);
+    replayJournal.replay(replayed, replayedIds);
+    bool replayTest = (replayed.size() == 3 && replayed.find(2000) != -1);
+    printSubAction("Journal reproduces the import", replayTest ? "YES" : "NO");
+    allPassed &= replayTest;
+    remove(journalPath.c_str());
+    
+    printStep(4, "Importing a row whose quote is never closed");
+    // The broken row swallows the following lines until the row limit,
+    // then the rest of that line; the row after it imports normally
+    string broken = "Name,Age,Phone,Address,Type\n"
+                    "\"Broken,20,03001234567,Street 1,Student\n" +
+                    string(CSV_MAX_ROW_BYTES + 100, 'x') + "\n"
+                    "Good,25,03001234567,Street 8,Student\n";
+    istringstream brokenCsv(broken);
+    ostringstream brokenErrors;
+    RecordStore brokenStore;
+    IdAllocator brokenIds;
+    Journal brokenJournal("../data/test_csv_broken_journal.log");
+    CsvImportResult brokenResult = CsvImporter(brokenStore, brokenIds, brokenJournal, brokenErrors).run(brokenCsv);
+    brokenJournal.close();
+    remove("../data/test_csv_broken_journal.log");
+    bool limitTest = (brokenResult.rows == 2 && brokenResult.imported == 1 && brokenResult.failed == 1 &&
+                      brokenErrors.str().find("line 3, row 1: row longer than") != string::npos &&
+                      brokenStore.size() == 1);
+    printSubAction("Oversized row rejected with its line number", limitTest ? "YES" : "NO");
+    allPassed &= limitTest;
+    
+    printTestResult("CSV Import/Export", allPassed, "Bulk rows validated, batched and journaled");
+    return allPassed;
+}
+
+#ifndef _WIN32
+// Send one request to a server and return every reply line up to the status line
+string serverRequest(int fd, const string &line) {
+    string request = line + "\n", reply;
+    send(fd, request.data(), request.size(), 0);
+    char ch;
+    string current;
+    while (recv(fd, &ch, 1, 0) == 1) {
+        reply += ch;
+        if (ch != '\n') {
+            current += ch;
+            continue;
+        }
+        if (current.compare(0, 2, "OK") == 0 || current.compare(0, 3, "ERR") == 0)
+            break;
+        current.clear();
+    }
+    return reply;
+}
+
+int connectToServer(const string &path) {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, (sockaddr *)&address, sizeof(address)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool testServerMode() {
+    printTestHeader("Server Mode");
+    printTestDescription("Serve the roster over a Unix socket to several clients reading and writing at once");
+    
+    bool allPassed = true;
+    string journalPath = "../data/test_server_journal.log";
+    string socketPath = "../data/test_server.sock";
+    remove(journalPath.c_str());
+    
+    printStep(1, "Starting the server");
+    RecordStore store;
+    IdAllocator ids;
+    Journal journal(journalPath);
+    Server server(store, ids, journal, socketPath);
+    bool started = server.start();
+    printSubAction("Listening on " + socketPath, started ? "YES" : "NO");
+    if (!started) {
+        printTestResult("Server Mode", false, "Socket could not be created");
+        return false;
+    }
+    thread serving([&server]() { server.run(); });
+    
+    printStep(2, "Four clients adding and reading back 25 records each, one searching");
+    const int CLIENTS = 4, PER_CLIENT = 25;
+    atomic<int> verified(0);
+    atomic<bool> writersDone(false);
+    atomic<int> searches(0);
+    vector<thread> clients;
+    for (int c = 0; c < CLIENTS; c++) {
+        clients.emplace_back([&, c]() {
+            int fd = connectToServer(socketPath);
+            for (int i = 0; i < PER_CLIENT && fd >= 0; i++) {
+                string name = "Client" + to_string(c) + " Person" + to_string(i);
+                string added = serverRequest(fd, "add`Student`" + name + "`20`03001234567`Street " + to_string(i));
+                if (added.compare(0, 17, "OK added Student ") != 0)
+                    continue;
+                string id = added.substr(17, added.size() - 18);
+                string record = serverRequest(fd, "get`" + id);
+                if (record.find("`" + name + "`") != string::npos && record.find("\nOK\n") != string::npos)
+                    verified++;
+            }
+            if (fd >= 0)
+                close(fd);
+        });
+    }
+    thread searcher([&]() {
+        int fd = connectToServer(socketPath);
+        while (fd >= 0 && !writersDone) {
+            if (serverRequest(fd, "find`client person").find("OK") != string::npos)
+                searches++;
+        }
+        if (fd >= 0)
+            close(fd);
+    });
+    for (thread &t : clients)
+        t.join();
+    writersDone = true;
+    searcher.join();
+    
+    bool concurrentTest = (verified == CLIENTS * PER_CLIENT && store.size() == CLIENTS * PER_CLIENT);
+    printSubAction("Records added and read back", to_string(verified.load()));
+    printSubAction("Searches answered meanwhile", to_string(searches.load()));
+    allPassed &= concurrentTest;
+    
+    printStep(3, "Checking queries and errors");
+    int fd = connectToServer(socketPath);
+    string stats = serverRequest(fd, "stats");
+    string prefix = serverRequest(fd, "prefix`client2`3");
+    string unknown = serverRequest(fd, "rename`1001");
+    close(fd);
+    bool queryTest = (stats == "OK 100 1100\n" && prefix.find("OK 3\n") != string::npos &&
+                      unknown.compare(0, 3, "ERR") == 0);
+    printSubAction("stats, prefix limit and unknown command", queryTest ? "YES" : "NO");
+    allPassed &= queryTest;
+    
+    printStep(4, "Stopping and replaying the journal");
+    server.stop();
+    serving.join();
+    journal.close();
+    RecordStore replayed;
+    IdAllocator replayedIds;
+    Journal replayJournal(journalPath);
+    replayJournal.replay(replayed, replayedIds);
+    bool replayTest = (replayed.size() == CLIENTS * PER_CLIENT);
+    printSubAction("Every acknowledged add is in the journal", replayTest ? "YES" : "NO");
+    allPassed &= replayTest;
+    remove(journalPath.c_str());
+    
+    printTestResult("Server Mode", allPassed, "Concurrent clients served from one store");
+    return allPassed;
+}
+#endif
+
 int main() {
     cout << string(80, '=') << endl;
     cout << "      SCHOOL MANAGEMENT SYSTEM - INTEGRATION TEST SUITE" << endl;
@@ -491,7 +873,7 @@ int main() {
     
     // Ask user about pause preference
     cout << "\nDo you want to pause after each integration test? (y/n): ";
-    char choice;
+    char choice = 'n';   // No input (e.g. under ctest) means no pauses
     cin >> choice;
     pauseAfterEachTest = (choice == 'y' || choice == 'Y');
     
@@ -509,6 +891,11 @@ int main() {
     testDataFileSystemIntegration();
     testCompleteSystemSimulation();
     testStressAndPerformance();
+    testBatchMode();
+    testCsvPipeline();
+#ifndef _WIN32
+    testServerMode();
+#endif
     
     // Print final summary
     cout << "\n" << string(80, '=') << endl;
@@ -3,10 +3,24 @@
 #include "../include/Teacher.h"
 #include "../include/Staff.h"
 #include "../include/Utility.h"
+#include "../include/RecordStore.h"
+#include "../include/RecordVersions.h"
+#include "../include/IdAllocator.h"
+#include "../include/ObjectPool.h"
+#include "../include/StringTable.h"
+#include "../include/RecordParser.h"
+#include "../include/FrameBuffer.h"
+#include "../include/Terminal.h"
+#include "../include/Metrics.h"
+#include "../include/MemoryAccounting.h"
+#include <sstream>
+#include <chrono>
+#include <thread>
+#include <atomic>
 #include <iostream>
 #include <string>
 #include <vector>
-#include <conio.h>  // For getch()
+#include <stdexcept>
 
 using namespace std;
 
@@ -20,7 +34,7 @@ int testsFailed = 0;
 void pauseIfRequested() {
     if (pauseAfterEachTest) {
         cout << "\nPress any key to continue to next test...";
-        getch();
+        Terminal::read_key();
         cout << "\n" << endl;
     }
 }
@@ -67,7 +81,7 @@ void printSubTest(const string& action, bool result, const string& expected = ""
     // Pause after each sub-test if user requested it
     if (pauseAfterEachTest) {
         cout << "Press any key to continue to next sub-test...";
-        getch();
+        Terminal::read_key();
         cout << endl;
     }
 }
@@ -304,6 +318,18 @@ bool testPolymorphism() {
     printSubTest("Get types through base pointers", typeTest);
     allPassed &= typeTest;
     
+    bool kindTest = (student->getKind() == KIND_STUDENT &&
+                     teacher->getKind() == KIND_TEACHER &&
+                     staff->getKind() == KIND_STAFF);
+    printSubTest("Kind tags match concrete types", kindTest);
+    allPassed &= kindTest;
+    
+    PersonKind parsed = KIND_COUNT;
+    bool nameRoundTrip = (Person::kind_from_name(Person::kind_name(KIND_STAFF), parsed) && parsed == KIND_STAFF &&
+                          !Person::kind_from_name("Janitor", parsed) && Person::create("Janitor") == nullptr);
+    printSubTest("Kind names round trip, unknown names rejected", nameRoundTrip);
+    allPassed &= nameRoundTrip;
+    
     cout << "\n4. Cleaning up polymorphic objects:" << endl;
     delete student;
     delete teacher;
@@ -349,6 +375,34 @@ bool testUtilityFunctions() {
         allPassed = false;
     }
     
+    cout << "\n2. Testing buffered rendering:" << endl;
+    int writesBefore = FrameBuffer::getWriteCount();
+    Utility::begin_frame();
+    Utility::print_menu_box("Buffered Menu", {"Option 1", "Option 2", "Exit"});
+    Utility::out() << "Enter your choice (1-3): " << endl;
+    Utility::end_frame();
+    int frameWrites = FrameBuffer::getWriteCount() - writesBefore;
+    bool frameTest = (frameWrites == 1);
+    printSubTest("Full menu redraw costs one write", frameTest, to_string(frameWrites) + " write(s)");
+    allPassed &= frameTest;
+    
+    cout << "\n3. Testing redraw latency budget:" << endl;
+    const int REDRAWS = 100;
+    vector<string> mainMenu = {"Enter Data", "View Data", "Modify Data", "Delete Data", "System Statistics", "Exit Program"};
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < REDRAWS; i++) {
+        Utility::begin_frame();
+        Utility::print_menu_box("SCHOOL MANAGEMENT SYSTEM", mainMenu);
+        Utility::out() << "Enter your choice (1-6): ";
+        Utility::end_frame();
+    }
+    long long averageMicros = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count() / REDRAWS;
+    cout << endl;
+    bool budgetTest = (averageMicros <= Terminal::REDRAW_BUDGET_MICROS);
+    printSubTest("Average main menu redraw within " + to_string(Terminal::REDRAW_BUDGET_MICROS) + " us", budgetTest,
+                 to_string(averageMicros) + " us");
+    allPassed &= budgetTest;
+    
     printTestResult("Utility Functions Testing", allPassed);
     return allPassed;
 }
@@ -396,6 +450,673 @@ bool testEdgeCases() {
     return allPassed;
 }
 
+bool testRecordStore() {
+    printTestHeader("Record Store");
+    cout << "Testing growable record storage beyond the old 100 slot limit..." << endl;
+    
+    bool allPassed = true;
+    RecordStore store;
+    const int RECORD_COUNT = 1000;
+    
+    cout << "\n1. Testing insert past 100 records:" << endl;
+    for (int i = 0; i < RECORD_COUNT; i++) {
+        Student* s = new Student();
+        s->setId(5000 + i);
+        s->save(store);
+    }
+    bool insertTest = (store.size() == RECORD_COUNT);
+    printSubTest("Insert " + to_string(RECORD_COUNT) + " students", insertTest, "Size: " + to_string(store.size()));
+    allPassed &= insertTest;
+    
+    cout << "\n2. Testing pointer stability while growing:" << endl;
+    Person* first = store.at(store.find(5000));
+    for (int i = 0; i < RECORD_COUNT; i++) {
+        Teacher* t = new Teacher();
+        t->setId(9000 + i);
+        t->save(store);
+    }
+    bool stableTest = (store.at(store.find(5000)) == first && first->getId() == 5000);
+    printSubTest("First record keeps its address after growth", stableTest);
+    allPassed &= stableTest;
+    
+    cout << "\n3. Testing erase and slot reuse:" << endl;
+    int slot = store.find(5010);
+    bool eraseTest = store.erase(slot) && store.find(5010) == -1 && store.size() == 2 * RECORD_COUNT - 1;
+    Staff* staff = new Staff();
+    staff->setId(7777);
+    staff->save(store);
+    bool reuseTest = (store.find(7777) == slot && store.slot_count() == 2 * RECORD_COUNT);
+    printSubTest("Erase record 5010", eraseTest);
+    printSubTest("Freed slot is reused by next insert", reuseTest);
+    allPassed &= eraseTest && reuseTest;
+    
+    int freed[3] = {store.find(5020), store.find(5021), store.find(5022)};
+    for (int i = 0; i < 3; i++) {
+        store.erase(freed[i]);
+    }
+    Student* filler = new Student();
+    filler->setId(7778);
+    store.replace(freed[1], filler);
+    int reused[2];
+    for (int i = 0; i < 2; i++) {
+        Student* s = new Student();
+        s->setId(7779 + i);
+        reused[i] = s->save(store) ? store.find(7779 + i) : -1;
+    }
+    bool freeListTest = (store.find(7778) == freed[1] && reused[0] == freed[2] && reused[1] == freed[0] &&
+                         store.slot_count() == 2 * RECORD_COUNT && store.size() == 2 * RECORD_COUNT);
+    printSubTest("Replacing into a free slot takes it off the free list", freeListTest);
+    allPassed &= freeListTest;
+    
+    cout << "\n4. Testing id index after replace:" << endl;
+    int teacherSlot = store.find(9000);
+    Teacher* replacement = new Teacher();
+    replacement->setId(20000);
+    replacement->save(store, teacherSlot);
+    bool indexTest = (store.find(9000) == -1 && store.find(20000) == teacherSlot &&
+                      store.find(5001) != -1 && store.at(store.find(5001))->getId() == 5001);
+    printSubTest("Lookups follow replaced records", indexTest);
+    allPassed &= indexTest;
+    
+    cout << "\n5. Testing iteration over live records:" << endl;
+    int visited = 0;
+    for (Person* p : store) {
+        if (p != nullptr) visited++;
+    }
+    bool iterateTest = (visited == store.size());
+    printSubTest("Iterate all live records", iterateTest, "Visited: " + to_string(visited));
+    allPassed &= iterateTest;
+    
+    cout << "\n6. Testing columnar scans:" << endl;
+    int counts[KIND_COUNT];
+    store.count_by_kind(counts);
+    bool countColumnTest = (counts[KIND_STUDENT] == RECORD_COUNT - 1 && counts[KIND_TEACHER] == RECORD_COUNT &&
+                            counts[KIND_STAFF] == 1);
+    printSubTest("Kind counts follow insert, erase and replace", countColumnTest,
+                 to_string(counts[KIND_STUDENT]) + "/" + to_string(counts[KIND_TEACHER]) + "/" + to_string(counts[KIND_STAFF]));
+    allPassed &= countColumnTest;
+    
+    staff->setAge(44);
+    staff->save(store, store.find(7777));
+    AgeStats staffAges = store.age_stats(KIND_STAFF);
+    bool ageColumnTest = (staffAges.count == 1 && staffAges.min_age == 44 && staffAges.average == 44.0 &&
+                          store.age_column()[store.find(7777)] == 44 && store.id_column()[store.find(7777)] == 7777);
+    printSubTest("Saving a record in place refreshes its columns", ageColumnTest);
+    allPassed &= ageColumnTest;
+    
+    cout << "\n7. Testing clear:" << endl;
+    store.clear();
+    bool clearTest = (store.empty() && store.begin().index() == store.end().index());
+    printSubTest("Clear deletes all records", clearTest);
+    allPassed &= clearTest;
+    
+    printTestResult("Record Store", allPassed);
+    return allPassed;
+}
+
+bool testObjectPool() {
+    printTestHeader("Object Pool");
+    cout << "Testing pooled allocation of records and bulk release..." << endl;
+    
+    bool allPassed = true;
+    
+    cout << "\n1. Testing block reuse:" << endl;
+    ObjectPool pool(40, 8);
+    void* first = pool.allocate();
+    pool.deallocate(first);
+    void* second = pool.allocate();
+    bool reuseTest = (first == second && pool.live_count() == 1);
+    printSubTest("Freed block is handed out again", reuseTest);
+    allPassed &= reuseTest;
+    
+    cout << "\n2. Testing chunk growth:" << endl;
+    vector<void*> blocks;
+    for (int i = 0; i < 20; i++) {
+        blocks.push_back(pool.allocate());
+    }
+    bool chunkTest = (pool.chunk_count() == 3 && pool.live_count() == 21);
+    printSubTest("21 blocks of 8 per chunk use 3 chunks", chunkTest, "Chunks: " + to_string(pool.chunk_count()));
+    allPassed &= chunkTest;
+    pool.release_all();
+    bool releaseTest = (pool.chunk_count() == 0 && pool.live_count() == 0);
+    printSubTest("release_all frees every chunk", releaseTest);
+    allPassed &= releaseTest;
+    
+    cout << "\n3. Testing records come from their type's pool:" << endl;
+    size_t before = Teacher::pool().live_count();
+    Person* teacher = Person::create(KIND_TEACHER);
+    bool teacherTest = (Teacher::pool().live_count() == before + 1);
+    delete teacher;
+    teacherTest &= (Teacher::pool().live_count() == before);
+    printSubTest("new/delete Teacher go through Teacher::pool()", teacherTest);
+    allPassed &= teacherTest;
+    
+    cout << "\n4. Testing thread-local runs:" << endl;
+    ObjectPool cached(40, 1024);
+    void* runFirst;
+    void* runSecond;
+    size_t liveInRun;
+    {
+        ObjectPool::LocalCache cache;
+        runFirst = cached.allocate();
+        runSecond = cached.allocate();
+        liveInRun = cached.live_count();
+    }
+    void* afterRun = cached.allocate();
+    bool cacheTest = ((char*)runSecond - (char*)runFirst == 48 && liveInRun == ObjectPool::LOCAL_RUN_BLOCKS &&
+                      cached.live_count() == 3 && afterRun != runFirst && afterRun != runSecond);
+    printSubTest("A run is reserved at once and its unused blocks handed back", cacheTest,
+                 "Live: " + to_string(cached.live_count()));
+    allPassed &= cacheTest;
+    
+    printTestResult("Object Pool", allPassed);
+    return allPassed;
+}
+
+bool testStringTable() {
+    printTestHeader("String Table");
+    cout << "Testing interning of repeated field values..." << endl;
+    
+    bool allPassed = true;
+    StringTable table;
+    
+    cout << "\n1. Testing handles:" << endl;
+    StringHandle first = table.intern(string_view("House 5, Street 1"));
+    StringHandle second = table.intern(string("House 5, Street 1"));
+    StringHandle other = table.intern(string_view("House 6, Street 1"));
+    bool handleTest = (first == second && first != other && table.get(first) == "House 5, Street 1");
+    printSubTest("Equal values share one handle", handleTest, to_string(first) + ", " + to_string(second));
+    allPassed &= handleTest;
+    bool emptyTest = (table.intern(string_view("")) == 0 && table.get(0).empty() && table.size() == 3);
+    printSubTest("Handle 0 is the empty string", emptyTest);
+    allPassed &= emptyTest;
+    string_view batch[] = {"House 6, Street 1", "Block C", "Block C", ""};
+    StringHandle batchHandles[4];
+    table.intern(batch, 4, batchHandles);
+    bool batchTest = (batchHandles[0] == other && batchHandles[1] == batchHandles[2] && batchHandles[3] == 0 &&
+                      table.get(batchHandles[1]) == "Block C" && table.size() == 4);
+    printSubTest("A batch interns like one call per value", batchTest);
+    allPassed &= batchTest;
+    
+    cout << "\n2. Testing records use the shared table:" << endl;
+    Teacher a, b;
+    a.setSubject("Mathematics");
+    b.setSubject("Mathematics");
+    a.setAddress("Block C");
+    b.setAddress("Block C");
+    bool recordTest = (&a.getSubject() == &b.getSubject() && a.getAddressHandle() == b.getAddressHandle() &&
+                       b.getAddress() == "Block C");
+    printSubTest("Records with equal subject and address share storage", recordTest);
+    allPassed &= recordTest;
+    
+    cout << "\n3. Testing a full table:" << endl;
+    StringTable small(2);
+    small.intern(string_view("Block A"));
+    small.intern(string_view("Block B"));
+    bool threw = false;
+    try {
+        small.intern(string_view("Block C"));
+    } catch (const length_error&) {
+        threw = true;
+    }
+    StringHandle missing;
+    bool fullTest = (threw && small.size() == 3 && !small.find("Block C", missing) &&
+                     small.intern(string_view("Block A")) == 1);
+    printSubTest("A new value past capacity throws, known values still resolve", fullTest);
+    allPassed &= fullTest;
+    
+    printTestResult("String Table", allPassed);
+    return allPassed;
+}
+
+bool testSecondaryIndexes() {
+    printTestHeader("Secondary Indexes");
+    cout << "Testing name, subject, designation and age queries..." << endl;
+    
+    bool allPassed = true;
+    RecordStore store;
+    const char* names[] = {"Ali Khan", "alina Shah", "Bilal Ahmed", "Sara Ali", "Aliya Noor"};
+    for (int i = 0; i < 5; i++) {
+        Person* person = Person::create((PersonKind)(i % KIND_COUNT));
+        person->setId(30000 + i);
+        person->setName(names[i]);
+        person->setAge(18 + i * 3);
+        person->setSubject(i == 1 ? "Physics" : "Math");
+        person->setDesignation("Clerk");
+        person->save(store);
+    }
+    
+    cout << "\n1. Testing name prefix search:" << endl;
+    vector<int> prefix = store.find_by_name_prefix("ALI");
+    bool prefixTest = (prefix.size() == 3 && store.at(prefix[0])->getName() == "Ali Khan" &&
+                       store.at(prefix[1])->getName() == "alina Shah" && store.at(prefix[2])->getName() == "Aliya Noor");
+    printSubTest("Case-insensitive prefix in name order", prefixTest, to_string(prefix.size()) + " matches");
+    allPassed &= prefixTest;
+    
+    cout << "\n2. Testing subject and designation lookups:" << endl;
+    vector<int> physics = store.find_by_subject("Physics");
+    vector<int> clerks = store.find_by_designation("Clerk");
+    bool hashTest = (physics.size() == 1 && store.at(physics[0])->getId() == 30001 &&
+                     clerks.size() == 1 && store.at(clerks[0])->getId() == 30002 &&
+                     store.find_by_subject("Astronomy").empty());
+    printSubTest("Physics teachers and clerks found", hashTest);
+    allPassed &= hashTest;
+    
+    cout << "\n3. Testing age range:" << endl;
+    vector<int> young = store.find_by_age(18, 24);
+    vector<int> youngStudents = store.find_by_age(18, 24, KIND_STUDENT);
+    bool ageTest = (young.size() == 3 && youngStudents.size() == 1 && store.at(youngStudents[0])->getId() == 30000);
+    printSubTest("Ages 18-24, all kinds and students only", ageTest);
+    allPassed &= ageTest;
+    
+    cout << "\n4. Testing index maintenance:" << endl;
+    int slot = store.find(30000);
+    Person* ali = store.at(slot);
+    ali->setName("Zubair");
+    ali->setAge(40);
+    ali->save(store, slot);
+    store.erase(store.find(30001));
+    bool maintainTest = (store.find_by_name_prefix("ali").size() == 1 && store.find_by_name_prefix("zub").size() == 1 &&
+                         store.find_by_age(18, 18).empty() && store.find_by_subject("Physics").empty());
+    printSubTest("Modify in place and delete update every index", maintainTest);
+    allPassed &= maintainTest;
+
+    cout << "\n5. Testing bulk load:" << endl;
+    RecordStore bulk;
+    bulk.begin_bulk_load();
+    for (int i = 4; i >= 0; i--) {
+        Person* person = Person::create((PersonKind)(i % KIND_COUNT));
+        person->setId(30000 + i);
+        person->setName(names[i]);
+        person->setAge(18 + i * 3);
+        person->setSubject(i == 1 ? "Physics" : "Math");
+        person->setDesignation("Clerk");
+        bulk.insert(person);
+    }
+    bool deferredTest = bulk.find_by_name_prefix("ali").empty() && bulk.find(30000) >= 0;
+    bulk.end_bulk_load();
+    vector<int> bulkPrefix = bulk.find_by_name_prefix("ALI");
+    vector<int> bulkYoung = bulk.find_by_age(18, 24);
+    vector<int> bulkSimilar = bulk.find_by_name("ali khan", 1);
+    bool builtTest = (bulkPrefix.size() == 3 && bulk.at(bulkPrefix[0])->getName() == "Ali Khan" &&
+                      bulk.at(bulkPrefix[2])->getName() == "Aliya Noor" && bulkYoung.size() == 3 &&
+                      bulk.at(bulkYoung[0])->getAge() == 18 && bulk.find_by_subject("Physics").size() == 1 &&
+                      bulk.find_by_designation("Clerk").size() == 1 && bulkSimilar.size() == 1 &&
+                      bulk.at(bulkSimilar[0])->getId() == 30000);
+    bulk.erase(bulk.find(30003));
+    bool afterTest = (bulk.find_by_name_prefix("sara").empty() && bulk.find_by_name_prefix("ali").size() == 3);
+    printSubTest("Indexes built once at the end match incremental ones", deferredTest && builtTest && afterTest);
+    allPassed &= deferredTest && builtTest && afterTest;
+
+    printTestResult("Secondary Indexes", allPassed);
+    return allPassed;
+}
+
+bool testNameSearch() {
+    printTestHeader("Name Search");
+    cout << "Testing ranked matching of partial and misspelled names..." << endl;
+    
+    bool allPassed = true;
+    RecordStore store;
+    const char* names[] = {"Muhammad Ali Khan", "Ayesha Siddiqui", "Bilal Ahmed", "Mohammad Bilal", "Sara Ahmed"};
+    for (int i = 0; i < 5; i++) {
+        Person* person = Person::create(KIND_STUDENT);
+        person->setId(31000 + i);
+        person->setName(names[i]);
+        person->setAge(20);
+        person->save(store);
+    }
+    
+    cout << "\n1. Testing misspelled query:" << endl;
+    vector<int> typo = store.find_by_name("ayesha sidiqi");
+    bool typoTest = (!typo.empty() && store.at(typo[0])->getName() == "Ayesha Siddiqui");
+    printSubTest("'ayesha sidiqi' finds Ayesha Siddiqui first", typoTest,
+                 typo.empty() ? "no matches" : store.at(typo[0])->getName());
+    allPassed &= typoTest;
+    
+    cout << "\n2. Testing partial query and ranking:" << endl;
+    vector<int> partial = store.find_by_name("bilal");
+    bool partialTest = (partial.size() == 2 && store.at(partial[0])->getName() == "Bilal Ahmed" &&
+                        store.at(partial[1])->getName() == "Mohammad Bilal");
+    printSubTest("'bilal' ranks the shorter full match first", partialTest, to_string(partial.size()) + " matches");
+    allPassed &= partialTest;
+    
+    vector<int> limited = store.find_by_name("ahmed", 1);
+    bool limitTest = (limited.size() == 1 && store.find_by_name("zzz").empty());
+    printSubTest("Result limit and no-match query", limitTest);
+    allPassed &= limitTest;
+    
+    cout << "\n3. Testing incremental updates:" << endl;
+    int slot = store.find(31004);
+    store.at(slot)->setName("Sana Qureshi");
+    store.at(slot)->save(store, slot);
+    store.erase(store.find(31002));
+    vector<int> renamed = store.find_by_name("sana qureshi");
+    vector<int> after = store.find_by_name("ahmed");
+    bool updateTest = (renamed.size() == 1 && store.at(renamed[0])->getId() == 31004 && after.empty());
+    printSubTest("Rename and delete are reflected immediately", updateTest);
+    allPassed &= updateTest;
+    
+    printTestResult("Name Search", allPassed);
+    return allPassed;
+}
+
+bool testRecordVersions() {
+    printTestHeader("Record Versions");
+    cout << "Testing point-in-time views and reclamation of old records..." << endl;
+    
+    bool allPassed = true;
+    int baseCount = Person::getCount();
+    RecordVersions versions;
+    {
+        RecordStore store;
+        for (int i = 0; i < 3; i++) {
+            Person* person = new Student();
+            person->setId(32000 + i);
+            person->setName("Version " + to_string(i));
+            person->setAge(20);
+            store.insert(person);
+        }
+        store.publish_to(&versions);
+        
+        cout << "\n1. Testing a view pinned before changes:" << endl;
+        bool viewTest;
+        {
+            RecordVersions::ReadView before(versions);
+            Person* copy = store.at(store.find(32000))->clone();
+            copy->setAge(30);
+            store.replace(store.find(32000), copy);
+            store.erase(store.find(32001));
+            
+            RecordVersions::ReadView after(versions);
+            viewTest = (before.find(32000) != nullptr && before.find(32000)->getAge() == 20 &&
+                        before.find(32001) != nullptr && after.find(32000)->getAge() == 30 &&
+                        after.find(32001) == nullptr && after.find(32002) != nullptr &&
+                        versions.retired_count() == 2 && Person::getCount() == baseCount + 4);
+        }
+        printSubTest("Old view keeps the old records, new view sees the changes", viewTest,
+                     to_string(versions.retired_count()) + " versions held back");
+        allPassed &= viewTest;
+        
+        cout << "\n2. Testing reclamation:" << endl;
+        Person* copy = store.at(store.find(32002))->clone();
+        copy->setName("Version 2b");
+        store.replace(store.find(32002), copy);
+        bool reclaimTest = (versions.retired_count() == 0 && Person::getCount() == baseCount + 2 &&
+                            store.size() == 2);
+        printSubTest("Replaced and deleted records freed once no view is open", reclaimTest,
+                     to_string(Person::getCount() - baseCount) + " records alive");
+        allPassed &= reclaimTest;
+        
+        cout << "\n3. Testing readers running alongside a writer:" << endl;
+        // The writer stores round r in 32002 first and then in 32000, so a
+        // consistent view never sees 32000 ahead of 32002
+        auto storeRound = [&store](int id, int round) {
+            Person* next = store.at(store.find(id))->clone();
+            next->setAge(round);
+            store.replace(store.find(id), next);
+        };
+        storeRound(32002, 0);
+        storeRound(32000, 0);
+        atomic<bool> done(false);
+        atomic<int> inconsistent(0);
+        vector<thread> readers;
+        for (int r = 0; r < 4; r++) {
+            readers.emplace_back([&]() {
+                while (!done) {
+                    RecordVersions::ReadView view(versions);
+                    const Person* first = view.find(32000);
+                    int firstRound = first->getAge();
+                    int secondRound = view.find(32002)->getAge();
+                    if (secondRound - firstRound < 0 || secondRound - firstRound > 1 ||
+                        view.find(32000) != first || first->getAge() != firstRound) {
+                        inconsistent++;
+                    }
+                }
+            });
+        }
+        for (int round = 1; round <= 20000; round++) {
+            storeRound(32002, round);
+            storeRound(32000, round);
+        }
+        done = true;
+        for (thread& reader : readers) {
+            reader.join();
+        }
+        bool concurrentTest = (inconsistent == 0 && store.at(store.find(32000))->getAge() == 20000);
+        printSubTest("4 lock-free readers see consistent views during 40000 updates", concurrentTest,
+                     to_string(inconsistent.load()) + " inconsistent views");
+        allPassed &= concurrentTest;
+        store.publish_to(nullptr);
+    }
+    bool cleanupTest = (Person::getCount() == baseCount);
+    printSubTest("Every version freed after the store detaches", cleanupTest);
+    allPassed &= cleanupTest;
+    
+    printTestResult("Record Versions", allPassed);
+    return allPassed;
+}
+
+bool testMetrics() {
+    printTestHeader("Metrics");
+    cout << "Testing latency histograms, counters and their text output..." << endl;
+    
+    bool allPassed = true;
+    Metrics::reset();
+    
+    cout << "\n1. Testing histogram buckets and percentiles:" << endl;
+    for (int i = 0; i < 98; i++) {
+        Metrics::record(TIMER_MODIFY, 500);
+    }
+    Metrics::record(TIMER_MODIFY, 3000);      // [2048, 4096) ns, bucket 2
+    Metrics::record(TIMER_MODIFY, 5000000);   // 5 ms, bucket 13
+    TimerStats modify = Metrics::snapshot().timers[TIMER_MODIFY];
+    double p99 = modify.percentile_us(0.99);
+    bool histogramTest = (modify.count == 100 && modify.buckets[0] == 98 && modify.buckets[2] == 1 &&
+                          modify.buckets[13] == 1 && modify.max_ns == 5000000 &&
+                          modify.percentile_us(0.5) < 1.0 && p99 >= 2.048 && p99 <= 4.096 &&
+                          modify.mean_us() > 50.5 && modify.mean_us() < 50.6);
+    printSubTest("100 samples land in the right buckets", histogramTest,
+                 "mean " + to_string(modify.mean_us()) + " us, p99 " + to_string(p99) + " us");
+    allPassed &= histogramTest;
+    
+    cout << "\n2. Testing counters and output formats:" << endl;
+    Metrics::count(COUNTER_REJECTED_CHANGES, 3);
+    ostringstream json, prometheus;
+    Metrics::write_json(json);
+    Metrics::write_prometheus(prometheus);
+    bool outputTest = (Metrics::snapshot().counters[COUNTER_REJECTED_CHANGES] == 3 &&
+                       json.str().find("\"modify\": {\"count\": 100,") != string::npos &&
+                       json.str().find("\"rejected_changes\": 3") != string::npos &&
+                       prometheus.str().find("sms_operation_duration_seconds_bucket{op=\"modify\",le=\"+Inf\"} 100\n") != string::npos &&
+                       prometheus.str().find("sms_operation_duration_seconds_count{op=\"modify\"} 100\n") != string::npos &&
+                       prometheus.str().find("sms_rejected_changes_total 3\n") != string::npos);
+    printSubTest("JSON and Prometheus text carry the counts", outputTest);
+    allPassed &= outputTest;
+    
+    cout << "\n3. Testing recording from several threads:" << endl;
+    vector<thread> workers;
+    for (int t = 0; t < 4; t++) {
+        workers.emplace_back([]() {
+            for (int i = 0; i < 10000; i++) {
+                Metrics::record(TIMER_ADD, 100);
+            }
+        });
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    // A later thread takes over a finished thread's shard, nothing is lost
+    thread([]() { ScopedTimer timer(TIMER_ADD); }).join();
+    TimerStats add = Metrics::snapshot().timers[TIMER_ADD];
+    bool threadTest = (add.count == 40001 && add.buckets[0] >= 40000);
+    printSubTest("4 threads x 10000 samples plus one more all counted", threadTest, to_string(add.count));
+    allPassed &= threadTest;
+    
+    cout << "\n4. Testing reset:" << endl;
+    Metrics::reset();
+    MetricsSnapshot cleared = Metrics::snapshot();
+    bool resetTest = (cleared.timers[TIMER_ADD].count == 0 && cleared.timers[TIMER_MODIFY].buckets[0] == 0 &&
+                      cleared.counters[COUNTER_REJECTED_CHANGES] == 0);
+    printSubTest("Counts start again from zero", resetTest);
+    allPassed &= resetTest;
+    
+    printTestResult("Metrics", allPassed);
+    return allPassed;
+}
+
+bool testMemoryAccounting() {
+    printTestHeader("Memory Accounting");
+    cout << "Testing per-subsystem allocation tracking and the memory report..." << endl;
+    
+    bool allPassed = true;
+    
+    cout << "\n1. Testing record pool chunks:" << endl;
+    size_t poolBefore = MemoryAccounting::in_use(MEM_RECORDS);
+    bool poolTest;
+    {
+        ObjectPool pool(64, 100);
+        pool.allocate();
+        pool.allocate();
+        size_t held = MemoryAccounting::in_use(MEM_RECORDS) - poolBefore;
+        pool.release_all();
+        poolTest = (held == 6400 && MemoryAccounting::in_use(MEM_RECORDS) == poolBefore);
+    }
+    printSubTest("One 100 x 64 byte chunk booked, given back by release_all", poolTest);
+    allPassed &= poolTest;
+    
+    cout << "\n2. Testing store, indexes and the report:" << endl;
+    size_t storeBefore = MemoryAccounting::in_use(MEM_STORE);
+    size_t indexBefore = MemoryAccounting::in_use(MEM_INDEXES);
+    bool reportTest;
+    {
+        RecordStore store;
+        for (int i = 0; i < 1000; i++) {
+            Person* person = new Student();
+            person->setId(33000 + i);
+            person->setName("Memory Accounting Student " + to_string(i));
+            person->setPhone("03001234567");
+            person->setAge(20);
+            store.insert(person);
+        }
+        MemoryReport report = MemoryAccounting::measure(store);
+        // Every slot needs a pointer, an id and an age at least
+        reportTest = (report.tracked[MEM_STORE] >= storeBefore + 1000 * (sizeof(Person*) + 2 * sizeof(int)) &&
+                      report.tracked[MEM_INDEXES] > indexBefore + 1000 * sizeof(int) &&
+                      report.record_bytes == 1000 * sizeof(Student) &&
+                      report.string_bytes >= 1000 * 27 &&
+                      report.accounted() > report.string_bytes + report.tracked[MEM_INDEXES]);
+        printSubTest("1000 records show up in every figure", reportTest,
+                     "store " + MemoryAccounting::format_bytes(report.tracked[MEM_STORE] - storeBefore) +
+                     ", indexes " + MemoryAccounting::format_bytes(report.tracked[MEM_INDEXES] - indexBefore) +
+                     ", names " + MemoryAccounting::format_bytes(report.string_bytes));
+    }
+    allPassed &= reportTest;
+    bool releaseTest = (MemoryAccounting::in_use(MEM_STORE) == storeBefore &&
+                        MemoryAccounting::in_use(MEM_INDEXES) == indexBefore);
+    printSubTest("Store and index memory given back with the store", releaseTest);
+    allPassed &= releaseTest;
+    
+    cout << "\n3. Testing record versions:" << endl;
+    size_t versionsBefore = MemoryAccounting::in_use(MEM_VERSIONS);
+    size_t versionsHeld;
+    {
+        RecordVersions versions;
+        versionsHeld = MemoryAccounting::in_use(MEM_VERSIONS) - versionsBefore;
+    }
+    bool versionsTest = (versionsHeld > 0 && MemoryAccounting::in_use(MEM_VERSIONS) == versionsBefore);
+    printSubTest("Version directory booked and given back", versionsTest, MemoryAccounting::format_bytes(versionsHeld));
+    allPassed &= versionsTest;
+    
+    cout << "\n4. Testing RSS and formatting:" << endl;
+    size_t rss = MemoryAccounting::process_rss();
+    bool formatTest = (rss > 0 && MemoryAccounting::format_bytes(512) == "512 B" &&
+                       MemoryAccounting::format_bytes(1536) == "1.5 KB" &&
+                       MemoryAccounting::format_bytes(3 * 1024 * 1024) == "3.0 MB");
+    printSubTest("Process RSS read, sizes formatted", formatTest, "RSS " + MemoryAccounting::format_bytes(rss));
+    allPassed &= formatTest;
+    
+    printTestResult("Memory Accounting", allPassed);
+    return allPassed;
+}
+
+bool testIdAllocator() {
+    printTestHeader("ID Allocator");
+    cout << "Testing ID generation, seeding and reuse of released IDs..." << endl;
+    
+    bool allPassed = true;
+    IdAllocator ids;
+    
+    cout << "\n1. Testing first IDs on an empty database:" << endl;
+    int first = ids.allocate();
+    int second = ids.allocate();
+    bool freshTest = (first == 1001 && second == 1002);
+    printSubTest("First two IDs are 1001 and 1002", freshTest, to_string(first) + ", " + to_string(second));
+    allPassed &= freshTest;
+    
+    cout << "\n2. Testing seeding from loaded records:" << endl;
+    ids.seed(1500);
+    ids.seed(1200);
+    int next = ids.allocate();
+    bool seedTest = (next == 1501 && ids.getHighWater() == 1501);
+    printSubTest("Next ID follows the highest loaded ID", seedTest, to_string(next));
+    allPassed &= seedTest;
+    
+    cout << "\n3. Testing reuse of released IDs:" << endl;
+    ids.release(1200);
+    ids.release(1200);
+    ids.release(999);
+    int reused = ids.allocate();
+    int after = ids.allocate();
+    bool reuseTest = (reused == 1200 && after == 1502 && ids.free_count() == 0);
+    printSubTest("Released ID is handed out once, then high-water resumes", reuseTest,
+                 to_string(reused) + ", " + to_string(after));
+    allPassed &= reuseTest;
+    
+    printTestResult("ID Allocator", allPassed);
+    return allPassed;
+}
+
+bool testRecordParser() {
+    printTestHeader("Record Parser");
+    cout << "Testing the shared backtick record parser..." << endl;
+    
+    bool allPassed = true;
+    
+    cout << "\n1. Testing teacher line parsing:" << endl;
+    Person* teacher = parse_record("Dr. Smith`45`03001234567`12 Main St`1005`Physics", RECORD_LAYOUTS[1]);
+    bool teacherTest = (teacher != nullptr && teacher->printType() == "Teacher" &&
+                        teacher->getName() == "Dr. Smith" && teacher->getAge() == 45 &&
+                        teacher->getAddress() == "12 Main St" && teacher->getId() == 1005 &&
+                        static_cast<Teacher*>(teacher)->getSubject() == "Physics");
+    printSubTest("Parse all six teacher fields", teacherTest);
+    allPassed &= teacherTest;
+    delete teacher;
+    
+    cout << "\n2. Testing malformed lines are rejected:" << endl;
+    Person* missingField = parse_record("Ali`20`03001234567`Street", RECORD_LAYOUTS[0]);
+    Person* badAge = parse_record("Ali`2O`03001234567`Street`1001", RECORD_LAYOUTS[0]);
+    bool malformedTest = (missingField == nullptr && badAge == nullptr);
+    printSubTest("Missing field and non-numeric age return nullptr", malformedTest);
+    allPassed &= malformedTest;
+    delete missingField;
+    delete badAge;
+    
+    cout << "\n3. Testing buffer parsing with CRLF and blank lines:" << endl;
+    string buffer = "Ali`20`03001234567`Street 1`1001\r\n\nSara`19`03007654321`Street 2`1002\nbroken line\n";
+    int records = 0, errors = 0;
+    parse_records(buffer, RECORD_LAYOUTS[0],
+                  [&](Person* p) { records += (p->getPhone() == "03001234567" || p->getId() == 1002); delete p; },
+                  [&](string_view) { errors++; });
+    bool bufferTest = (records == 2 && errors == 1);
+    printSubTest("Two records and one error", bufferTest,
+                 to_string(records) + " records, " + to_string(errors) + " errors");
+    allPassed &= bufferTest;
+    
+    printTestResult("Record Parser", allPassed);
+    return allPassed;
+}
+
 int main() {
     cout << string(80, '=') << endl;
     cout << "         SCHOOL MANAGEMENT SYSTEM - UNIT TEST SUITE" << endl;
@@ -405,7 +1126,7 @@ int main() {
     
     // Ask user about pause preference
     cout << "\nDo you want to pause after each test? (y/n): ";
-    char choice;
+    char choice = 'n';   // No input (e.g. under ctest) means no pauses
     cin >> choice;
     pauseAfterEachTest = (choice == 'y' || choice == 'Y');
     
@@ -422,6 +1143,16 @@ int main() {
     testPolymorphism();
     testUtilityFunctions();
     testEdgeCases();
+    testRecordStore();
+    testObjectPool();
+    testStringTable();
+    testSecondaryIndexes();
+    testNameSearch();
+    testRecordVersions();
+    testMetrics();
+    testMemoryAccounting();
+    testIdAllocator();
+    testRecordParser();
     
     // Print final summary
     cout << "\n" << string(80, '=') << endl;
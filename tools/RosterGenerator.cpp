@@ -0,0 +1,330 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <sys/stat.h>
+
+using namespace std;
+
+// gen_roster: writes N synthetic records as students.txt, teachers.txt and
+// staff.txt in the backtick format read_person loads:
+//   name`age`phone`address`id[`subject or designation]
+//
+// gen_roster N [--seed S] [--out DIR] [--mix STUDENTS:TEACHERS:STAFF]
+//              [--student-ages MIN-MAX] [--teacher-ages MIN-MAX]
+//              [--staff-ages MIN-MAX] [--first-id ID]
+//
+// Output depends only on the arguments, the same seed gives the same files.
+// Names, neighborhoods, subjects and designations are drawn from fixed
+// lists with skewed weights, so values repeat the way they do on a real
+// roster. Phones are valid 03XXXXXXXXX numbers, ids run up from --first-id.
+// Defaults: 1000000 records, seed 1, ../data, mix 85:10:5, student ages
+// 18-25, teacher ages 25-50, staff ages 20-50.
+
+const char *FIRST[] = {"Muhammad", "Ahmed", "Ali", "Hassan", "Hussain", "Usman", "Bilal", "Hamza", "Zain", "Omar",
+                       "Fatima", "Ayesha", "Zainab", "Maryam", "Sana", "Hira", "Sara", "Amna", "Iqra", "Noor",
+                       "Daniyal", "Faisal", "Imran", "Kamran", "Saad", "Talha", "Waqas", "Yasir", "Asad", "Fahad",
+                       "Mehwish", "Rabia", "Saima", "Nadia", "Farah", "Huma", "Kiran", "Laiba", "Mahnoor", "Areeba",
+                       "Abdullah", "Haris", "Junaid", "Shahzaib", "Taimoor", "Rida", "Anam", "Javeria", "Sidra", "Komal"};
+const char *LAST[] = {"Khan", "Ahmed", "Ali", "Hussain", "Shah", "Malik", "Qureshi", "Siddiqui", "Butt", "Chaudhry",
+                      "Sheikh", "Raza", "Iqbal", "Javed", "Mirza", "Abbasi", "Baig", "Rana", "Awan", "Zaidi",
+                      "Rizvi", "Hashmi", "Gillani", "Bukhari", "Niazi", "Khattak", "Afridi", "Yousafzai", "Memon", "Soomro"};
+const char *AREAS[] = {"Gulberg", "Model Town", "Johar Town", "DHA Phase 5", "Bahria Town", "Faisal Town", "Garden Town",
+                       "Iqbal Town", "Township", "Wapda Town", "Cantt", "Samanabad", "Shadman", "Valencia",
+                       "G-9 Markaz", "F-7", "I-8", "Satellite Town", "Clifton", "Gulshan-e-Iqbal", "North Nazimabad",
+                       "PECHS", "Saddar", "Hayatabad", "University Town"};
+const char *CITIES[] = {"Lahore", "Islamabad", "Karachi", "Rawalpindi", "Peshawar", "Faisalabad", "Multan"};
+const int CITY_WEIGHTS[] = {35, 20, 20, 10, 6, 5, 4};
+const char *SUBJECTS[] = {"Mathematics", "English", "Physics", "Chemistry", "Biology", "Computer Science", "Urdu",
+                          "Islamiat", "Pakistan Studies", "Economics", "Statistics", "Accounting", "Geography",
+                          "History", "Psychology", "Sociology"};
+const int SUBJECT_WEIGHTS[] = {20, 16, 12, 11, 10, 9, 8, 6, 5, 4, 3, 3, 2, 2, 1, 1};
+const char *DESIGNATIONS[] = {"Clerk", "Office Assistant", "Accountant", "Librarian", "Lab Assistant", "Security Guard",
+                              "Administrator", "IT Support", "Registrar", "Principal"};
+const int DESIGNATION_WEIGHTS[] = {25, 20, 10, 8, 10, 12, 6, 5, 3, 1};
+
+const int WEIGHT_TABLE_BITS = 12;
+
+// splitmix64: tiny, fast and fully determined by the seed
+class Random {
+private:
+    uint64_t state;
+
+public:
+    explicit Random(uint64_t seed) : state(seed) {}
+
+    uint64_t next()
+    {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [0, bound)
+    uint32_t below(uint32_t bound) { return (uint32_t)(((next() >> 32) * bound) >> 32); }
+};
+
+// Weighted choice through a lookup table, one random draw per pick
+class WeightedPick {
+private:
+    vector<uint8_t> table;
+
+public:
+    WeightedPick(const int *weights, int count) : table(1u << WEIGHT_TABLE_BITS)
+    {
+        int total = 0;
+        for (int i = 0; i < count; i++)
+        {
+            total += weights[i];
+        }
+        size_t filled = 0;
+        int sum = 0;
+        for (int i = 0; i < count; i++)
+        {
+            sum += weights[i];
+            size_t end = (size_t)sum * table.size() / total;
+            while (filled < end)
+            {
+                table[filled++] = (uint8_t)i;
+            }
+        }
+    }
+
+    int pick(Random &random) const { return table[random.next() & (table.size() - 1)]; }
+};
+
+// Buffered file writer, avoids iostream formatting on the hot path
+class Output {
+private:
+    FILE *file;
+    vector<char> buffer;
+    size_t used;
+
+public:
+    Output() : file(nullptr), buffer(1 << 20), used(0) {}
+
+    bool open(const string &path)
+    {
+        file = fopen(path.c_str(), "wb");
+        return file != nullptr;
+    }
+
+    void flush()
+    {
+        if (used > 0)
+        {
+            fwrite(buffer.data(), 1, used, file);
+            used = 0;
+        }
+    }
+
+    void text(const char *value)
+    {
+        size_t length = strlen(value);
+        if (used + length > buffer.size())
+            flush();
+        memcpy(buffer.data() + used, value, length);
+        used += length;
+    }
+
+    void character(char c)
+    {
+        if (used == buffer.size())
+            flush();
+        buffer[used++] = c;
+    }
+
+    void number(uint32_t value)
+    {
+        char digits[10];
+        int count = 0;
+        do
+        {
+            digits[count++] = (char)('0' + value % 10);
+            value /= 10;
+        } while (value > 0);
+        if (used + count > buffer.size())
+            flush();
+        while (count > 0)
+        {
+            buffer[used++] = digits[--count];
+        }
+    }
+
+    // Flush and close, false if anything failed to write
+    bool close()
+    {
+        flush();
+        bool ok = file != nullptr && !ferror(file);
+        if (file != nullptr && fclose(file) != 0)
+            ok = false;
+        file = nullptr;
+        return ok;
+    }
+};
+
+struct AgeRange {
+    int min_age;
+    int max_age;
+};
+
+bool parse_range(const string &text, AgeRange &range)
+{
+    return sscanf(text.c_str(), "%d-%d", &range.min_age, &range.max_age) == 2 && range.min_age >= 18 &&
+           range.max_age <= 50 && range.min_age <= range.max_age;
+}
+
+void write_common(Output &out, Random &random, const AgeRange &ages, const WeightedPick &cities, int id)
+{
+    // Name: first [middle] last, about a third have a middle name
+    out.text(FIRST[random.below(50)]);
+    out.character(' ');
+    if (random.below(3) == 0)
+    {
+        out.text(FIRST[random.below(50)]);
+        out.character(' ');
+    }
+    out.text(LAST[random.below(30)]);
+    out.character('`');
+
+    // Ages lean toward the young end of the range
+    uint32_t span = (uint32_t)(ages.max_age - ages.min_age + 1);
+    out.number((uint32_t)ages.min_age + min(random.below(span), random.below(span)));
+    out.character('`');
+
+    // 03 + network code 0-4 + 8 digits
+    out.text("03");
+    out.number(random.below(5));
+    uint32_t subscriber = random.below(100000000);
+    for (uint32_t digit = 10000000; digit > 0; digit /= 10)
+    {
+        out.character((char)('0' + subscriber / digit % 10));
+    }
+    out.character('`');
+
+    // Few houses per street and streets per area, so addresses repeat
+    out.text("House ");
+    out.number(1 + random.below(200));
+    out.text(", Street ");
+    out.number(1 + random.below(20));
+    out.text(", ");
+    out.text(AREAS[random.below(25)]);
+    out.text(", ");
+    out.text(CITIES[cities.pick(random)]);
+    out.character('`');
+    out.number((uint32_t)id);
+}
+
+int main(int argc, char *argv[])
+{
+    long long records = 1000000;
+    uint64_t seed = 1;
+    string directory = "../data";
+    int mix[3] = {85, 10, 5};
+    AgeRange ages[3] = {{18, 25}, {25, 50}, {20, 50}};
+    long long first_id = 1001;
+
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        bool ok = true;
+        if (arg == "--seed" && has_value)
+            seed = strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--out" && has_value)
+            directory = argv[++i];
+        else if (arg == "--mix" && has_value)
+            ok = sscanf(argv[++i], "%d:%d:%d", &mix[0], &mix[1], &mix[2]) == 3 && mix[0] >= 0 && mix[1] >= 0 &&
+                 mix[2] >= 0 && mix[0] + mix[1] + mix[2] > 0;
+        else if (arg == "--student-ages" && has_value)
+            ok = parse_range(argv[++i], ages[0]);
+        else if (arg == "--teacher-ages" && has_value)
+            ok = parse_range(argv[++i], ages[1]);
+        else if (arg == "--staff-ages" && has_value)
+            ok = parse_range(argv[++i], ages[2]);
+        else if (arg == "--first-id" && has_value)
+            ok = (first_id = atoll(argv[++i])) > 0;
+        else
+            ok = (records = atoll(argv[i])) >= 0 && arg.find_first_not_of("0123456789") == string::npos;
+        if (!ok)
+        {
+            cerr << "Invalid argument: " << argv[i] << endl
+                 << "Usage: gen_roster N [--seed S] [--out DIR] [--mix STUDENTS:TEACHERS:STAFF]" << endl
+                 << "                  [--student-ages MIN-MAX] [--teacher-ages MIN-MAX] [--staff-ages MIN-MAX]"
+                 << " [--first-id ID]" << endl
+                 << "Ages must lie within 18-50." << endl;
+            return 2;
+        }
+    }
+    if (first_id + records - 1 > 2147483647LL)
+    {
+        cerr << "Ids would not fit in an int, lower N or --first-id." << endl;
+        return 2;
+    }
+
+    const char *files[3] = {"/students.txt", "/teachers.txt", "/staff.txt"};
+    Output outputs[3];
+    for (int kind = 0; kind < 3; kind++)
+    {
+        if (!outputs[kind].open(directory + files[kind]))
+        {
+            cerr << "Cannot write " << directory << files[kind] << endl;
+            return 1;
+        }
+    }
+
+    auto start = chrono::steady_clock::now();
+    Random random(seed);
+    WeightedPick kinds(mix, 3);
+    WeightedPick cities(CITY_WEIGHTS, 7);
+    WeightedPick subjects(SUBJECT_WEIGHTS, 16);
+    WeightedPick designations(DESIGNATION_WEIGHTS, 10);
+    long long written[3] = {0, 0, 0};
+    for (long long i = 0; i < records; i++)
+    {
+        int kind = kinds.pick(random);
+        Output &out = outputs[kind];
+        write_common(out, random, ages[kind], cities, (int)(first_id + i));
+        if (kind == 1)
+        {
+            out.character('`');
+            out.text(SUBJECTS[subjects.pick(random)]);
+        }
+        else if (kind == 2)
+        {
+            out.character('`');
+            out.text(DESIGNATIONS[designations.pick(random)]);
+        }
+        out.character('\n');
+        written[kind]++;
+    }
+
+    bool ok = true;
+    for (Output &out : outputs)
+    {
+        ok = out.close() && ok;
+    }
+    if (!ok)
+    {
+        cerr << "Writing the roster failed (disk full?)" << endl;
+        return 1;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "Wrote " << written[0] << " students, " << written[1] << " teachers, " << written[2] << " staff to "
+         << directory << " in " << seconds << " s" << endl;
+
+    // A journal left from the old roster would be replayed on top of this one
+    struct stat info;
+    if (stat((directory + "/journal.log").c_str(), &info) == 0 && info.st_size > 0)
+    {
+        cerr << "Note: " << directory << "/journal.log holds changes to the previous roster, delete it before "
+             << "starting sms." << endl;
+    }
+    return 0;
+}